@@ -0,0 +1,270 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+/*
+ * Compares the Scribo binarizations on synthetic degraded document
+ * pages: for each resolution, times each binarization per megapixel
+ * and measures its accuracy against the ground truth the page was
+ * drawn from.
+ *
+ * The pages are A4 pages of text-like glyphs, with an uneven
+ * illumination, noise and a reverse video block. The pages and thus
+ * the results only depend on the seed.
+ *
+ * Usage: binarization [seed [dpi...]]
+ */
+
+#include <QtCore/QTime>
+#include <QtCore/QList>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+#include <mln/core/image/image2d.hh>
+#include <mln/value/int_u8.hh>
+#include <mln/value/rgb8.hh>
+
+#include <scribo/binarization/sauvola.hh>
+#include <scribo/binarization/sauvola_ms.hh>
+#include <scribo/binarization/sauvola_ms_split.hh>
+#include <scribo/binarization/global_threshold_auto.hh>
+
+using namespace mln;
+
+namespace {
+/**
+ * A small linear congruential generator, so that the pages do not
+ * depend on the C library.
+ */
+class Random
+{
+public:
+    Random( unsigned seed )
+        : m_state( seed ) {
+    }
+
+    /// A number in [0, n[.
+    unsigned next( unsigned n ) {
+        m_state = m_state * 1103515245u + 12345u;
+        return ( m_state >> 8 ) % n;
+    }
+
+private:
+    unsigned m_state;
+};
+
+
+/**
+ * A synthetic page and its ground truth: true where a binarization
+ * should find the dark pixels.
+ */
+struct Page
+{
+    image2d<value::int_u8> gray;
+    image2d<value::rgb8> color;
+    image2d<bool> truth;
+};
+
+
+/**
+ * Draw glyphs made of strokes on the lines of a text block.
+ * \p ink is the value of the strokes in the ground truth.
+ */
+void drawText( image2d<bool>& truth, Random& random, const box2d& block,
+               int xHeight, bool ink )
+{
+    const int stroke = std::max( 1, xHeight / 5 );
+    const int lineHeight = 2 * xHeight;
+
+    for ( int row = block.pmin().row(); row + xHeight <= block.pmax().row(); row += lineHeight ) {
+        int col = block.pmin().col();
+        while ( col + xHeight <= block.pmax().col() ) {
+            // A word of 2 to 9 glyphs.
+            const int nglyphs = 2 + random.next( 8 );
+            for ( int g = 0; g < nglyphs && col + xHeight <= block.pmax().col(); ++g ) {
+                const int width = xHeight / 2 + random.next( xHeight / 2 + 1 );
+                const unsigned shape = random.next( 16 ) | 1;
+                // Ascenders on some glyphs.
+                const int top = ( shape & 8 ) ? row - xHeight / 2 : row;
+                for ( int r = top; r < row + xHeight; ++r ) {
+                    for ( int c = col; c < col + width; ++c ) {
+                        const bool left = c - col < stroke;
+                        const bool right = ( shape & 2 ) && col + width - c <= stroke;
+                        const bool bottom = ( shape & 4 ) && row + xHeight - r <= stroke;
+                        const bool middle = ( shape & 16 ) == 0 && ( shape & 2 ) == 0
+                                            && std::abs( r - ( row + xHeight / 2 ) ) < stroke / 2 + 1;
+                        if ( left || right || bottom || middle )
+                            truth.at_( r, c ) = ink;
+                    }
+                }
+                col += width + stroke + 1;
+            }
+            col += xHeight;
+        }
+    }
+}
+
+
+/**
+ * An A4 page at \p dpi dots per inch.
+ */
+Page makePage( unsigned dpi, unsigned seed )
+{
+    Random random( seed );
+    const int nrows = 297 * dpi / 25.4;
+    const int ncols = 210 * dpi / 25.4;
+    const int margin = dpi / 2;
+    // 10 and 16 points fonts.
+    const int xHeight = std::max( 4u, dpi * 10 / 72 / 2 );
+    const int titleHeight = std::max( 6u, dpi * 16 / 72 / 2 );
+
+    Page page;
+    page.truth = image2d<bool>( nrows, ncols );
+    data::fill( page.truth, false );
+
+    // A title, a reverse video block and two columns of text.
+    const box2d title = make::box2d( margin, margin,
+                                     margin + 3 * titleHeight, ncols - margin );
+    const box2d reverse = make::box2d( title.pmax().row() + xHeight, margin,
+                                       title.pmax().row() + 10 * xHeight, ncols - margin );
+    const int columnsTop = reverse.pmax().row() + 2 * xHeight;
+    const int middle = ncols / 2;
+    drawText( page.truth, random, title, titleHeight, true );
+    data::fill( ( page.truth | reverse ).rw(), true );
+    drawText( page.truth, random,
+              make::box2d( reverse.pmin().row() + xHeight, reverse.pmin().col() + xHeight,
+                           reverse.pmax().row() - xHeight, reverse.pmax().col() - xHeight ),
+              xHeight, false );
+    drawText( page.truth, random,
+              make::box2d( columnsTop, margin, nrows - margin, middle - xHeight ),
+              xHeight, true );
+    drawText( page.truth, random,
+              make::box2d( columnsTop, middle + xHeight, nrows - margin, ncols - margin ),
+              xHeight, true );
+
+    // Uneven illumination: the paper gets darker towards the bottom
+    // right corner, as when a page is photographed.
+    page.gray = image2d<value::int_u8>( nrows, ncols );
+    page.color = image2d<value::rgb8>( nrows, ncols );
+    for ( int row = 0; row < nrows; ++row ) {
+        for ( int col = 0; col < ncols; ++col ) {
+            const double shade = double( row ) / nrows + double( col ) / ncols;
+            const int paper = int( 235 - 45 * shade * shade );
+            const int ink = int( 35 + 20 * shade );
+            int v = page.truth.at_( row, col ) ? ink : paper;
+
+            // Noise, and a few specks.
+            v += int( random.next( 21 ) + random.next( 21 ) ) - 20;
+            if ( random.next( 2000 ) == 0 )
+                v = random.next( 256 );
+            v = std::max( 0, std::min( 255, v ) );
+
+            page.gray.at_( row, col ) = v;
+            page.color.at_( row, col ) = value::rgb8( v, std::max( 0, v - 10 ), std::max( 0, v - 25 ) );
+        }
+    }
+
+    return page;
+}
+
+
+struct Score
+{
+    double accuracy;
+    double fMeasure;
+};
+
+
+/**
+ * Pixel accuracy and F-measure of the dark pixels found in \p output.
+ */
+Score score( const image2d<bool>& output, const image2d<bool>& truth )
+{
+    unsigned long tp = 0, fp = 0, fn = 0, n = 0;
+    mln_piter_( box2d ) p( truth.domain() );
+    for_all( p ) {
+        const bool o = output( p ), t = truth( p );
+        tp += o && t;
+        fp += o && !t;
+        fn += !o && t;
+        ++n;
+    }
+
+    Score s;
+    s.accuracy = 1. - double( fp + fn ) / n;
+    s.fMeasure = tp ? 2. * tp / ( 2. * tp + fp + fn ) : 0.;
+    return s;
+}
+
+
+void report( unsigned dpi, const char* name, const Page& page,
+             const image2d<bool>& output, int elapsed )
+{
+    const double mpixels = page.gray.nelements() / 1e6;
+    const Score s = score( output, page.truth );
+    std::printf( "%u\t%-24s %8d %10.1f %10.4f %10.4f\n", dpi, name, elapsed,
+                 elapsed / mpixels, s.accuracy, s.fMeasure );
+}
+}
+
+
+int main( int argc, char** argv )
+{
+    const unsigned seed = argc > 1 ? std::atoi( argv[1] ) : 1;
+    QList<unsigned> dpis;
+    for ( int i = 2; i < argc; ++i )
+        dpis.append( std::atoi( argv[i] ) );
+    if ( dpis.isEmpty() )
+        dpis << 150 << 300;
+
+    std::printf( "dpi\tbinarization                   ms      ms/MP   accuracy  F-measure\n" );
+
+    Q_FOREACH( unsigned dpi, dpis ) {
+        const Page page = makePage( dpi, seed );
+        // Windows of about a third of an inch, as in the toolchains.
+        const unsigned window = dpi / 3 | 1;
+        QTime time;
+        image2d<bool> output;
+
+        time.start();
+        output = scribo::binarization::sauvola( page.gray, window );
+        report( dpi, "sauvola", page, output, time.elapsed() );
+
+        time.start();
+        output = scribo::binarization::sauvola_ms( page.gray, window, 3 );
+        report( dpi, "sauvola_ms", page, output, time.elapsed() );
+
+        time.start();
+        output = scribo::binarization::sauvola_ms_split( page.color, window, 3, 2 );
+        report( dpi, "sauvola_ms_split", page, output, time.elapsed() );
+
+        time.start();
+        output = scribo::binarization::global_threshold_auto( page.gray );
+        report( dpi, "global_threshold_auto", page, output, time.elapsed() );
+    }
+
+    return 0;
+}
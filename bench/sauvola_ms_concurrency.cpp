@@ -0,0 +1,134 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+/*
+ * Runs N sauvola_ms binarizations concurrently, one page per thread,
+ * and reports the throughput for each N. Since the binarization does
+ * not share any state between calls, the throughput should scale
+ * linearly up to the number of cores.
+ *
+ * Usage: sauvola_ms_concurrency [max_threads [nrows ncols]]
+ */
+
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
+#include <QtCore/QTime>
+#include <QtCore/QList>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <mln/core/image/image2d.hh>
+#include <mln/value/int_u8.hh>
+
+#include <scribo/binarization/sauvola_ms.hh>
+
+using namespace mln;
+
+namespace {
+/**
+ * A synthetic page: dark text-like strokes of several sizes on a
+ * noisy, slowly varying background.
+ */
+image2d<value::int_u8> makePage( int nrows, int ncols, unsigned seed )
+{
+    image2d<value::int_u8> page( nrows, ncols );
+    unsigned x = seed;
+    for ( int row = 0; row < nrows; ++row ) {
+        for ( int col = 0; col < ncols; ++col ) {
+            x = x * 1103515245u + 12345u;
+            const int size = 8 << ( ( row / 256 ) % 3 );
+            const bool ink = ( row % ( 2 * size ) ) < size
+                             && ( col % ( 3 * size ) ) < size / 2 + ( row % size );
+            const int background = 160 + ( row + col ) * 80 / ( nrows + ncols );
+            page.at_( row, col ) = ink ? 30 + ( x >> 27 ) : background + ( x >> 28 );
+        }
+    }
+    return page;
+}
+
+
+class BinarizationRunnable : public QRunnable
+{
+public:
+    BinarizationRunnable( const image2d<value::int_u8>& page )
+        : m_page( page ) {
+        setAutoDelete( false );
+    }
+
+    void run() {
+        m_result = scribo::binarization::sauvola_ms( m_page, 101, 3,
+                                                     SCRIBO_DEFAULT_SAUVOLA_K );
+    }
+
+private:
+    const image2d<value::int_u8>& m_page;
+    image2d<bool> m_result;
+};
+}
+
+
+int main( int argc, char** argv )
+{
+    const int maxThreads = argc > 1 ? std::atoi( argv[1] ) : QThread::idealThreadCount();
+    const int nrows = argc > 3 ? std::atoi( argv[2] ) : 3500;
+    const int ncols = argc > 3 ? std::atoi( argv[3] ) : 2500;
+
+    // One page per thread: Milena images are reference counted without
+    // locking, so the threads must not share them.
+    QList<image2d<value::int_u8> > pages;
+    for ( int i = 0; i < maxThreads; ++i )
+        pages.append( makePage( nrows, ncols, i + 1 ) );
+
+    QList<BinarizationRunnable*> runnables;
+    for ( int i = 0; i < maxThreads; ++i )
+        runnables.append( new BinarizationRunnable( pages[i] ) );
+
+    QThreadPool pool;
+    pool.setMaxThreadCount( maxThreads );
+
+    std::printf( "%dx%d pages\n", nrows, ncols );
+    std::printf( "threads\ttime (ms)\tpages/s\tefficiency\n" );
+
+    double singleThroughput = 0;
+    for ( int n = 1; n <= maxThreads; ++n ) {
+        QTime time;
+        time.start();
+        for ( int i = 0; i < n; ++i )
+            pool.start( runnables[i] );
+        pool.waitForDone();
+        const int elapsed = qMax( time.elapsed(), 1 );
+
+        const double throughput = 1000. * n / elapsed;
+        if ( n == 1 )
+            singleThroughput = throughput;
+        std::printf( "%d\t%d\t\t%.2f\t%.2f\n", n, elapsed, throughput,
+                     throughput / ( n * singleThroughput ) );
+    }
+
+    qDeleteAll( runnables );
+    return 0;
+}
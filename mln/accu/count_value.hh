@@ -96,6 +96,9 @@ namespace mln
       /// Always true here.
       bool is_valid() const;
 
+      /// Give the value which is counted.
+      const V& ref() const;
+
     protected:
       /// The value of the counter.
       unsigned count_;
@@ -218,6 +221,15 @@ namespace mln
       return valid_;
     }
 
+    template <typename V>
+    inline
+    const V&
+    count_value<V>::ref() const
+    {
+      mln_precondition(is_valid());
+      return ref_;
+    }
+
 # endif // ! MLN_INCLUDE_ONLY
 
   } // end of namespace mln::accu
@@ -53,6 +53,7 @@ namespace mln
 # include <mln/canvas/labeling/blobs.hh>
 # include <mln/canvas/labeling/generic.hh>
 # include <mln/canvas/labeling/video.hh>
+# include <mln/canvas/labeling/runs.hh>
 # include <mln/canvas/labeling/sorted.hh>
 
 
@@ -0,0 +1,452 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+#ifndef MLN_CANVAS_LABELING_RUNS_HH
+# define MLN_CANVAS_LABELING_RUNS_HH
+
+/// \file
+///
+/// Connected component labeling of 2D images by horizontal runs.
+
+# include <cstdlib>
+# include <vector>
+# include <algorithm>
+
+# include <mln/core/image/image2d.hh>
+# include <mln/core/alias/neighb2d.hh>
+# include <mln/data/fill.hh>
+# include <mln/literal/zero.hh>
+# include <mln/canvas/labeling/video.hh>
+
+
+namespace mln
+{
+
+  namespace canvas
+  {
+
+    namespace labeling
+    {
+
+      /*! \brief Connected component labeling by horizontal runs.
+
+	\param[in]     input   The input image.
+	\param[in]     nbh     The connectivity: c4() or c8().
+	\param[out]    nlabels The number of labels.
+	\param[in,out] functor A functor computing data while labeling.
+
+	\return The label image.
+
+	The sites handled by \p functor are grouped into horizontal
+	runs, and the overlapping runs of consecutive rows are merged
+	with a union-find on the runs. Labels are numbered in the
+	order of the first site of each component, and \p functor is
+	notified of the labeled sites in the forward order, exactly
+	as in video().
+
+	\p functor must label the connected sets of the sites it
+	handles: its equiv_() returns handles_() of the neighbor, and
+	it does not compute attributes during the union-find, so
+	init_attr_(), merge_attr_() and do_no_union_() are not called.
+       */
+      template <typename V, typename L, typename F>
+      image2d<L>
+      runs(const image2d<V>& input, const neighb2d& nbh,
+	   L& nlabels, F& functor);
+
+      /// \overload
+      /// The runs are extracted by bands of rows on \p nthreads
+      /// threads if OpenMP is available. The band boundaries are
+      /// merged afterwards, so the result does not depend on
+      /// \p nthreads. \p functor is still notified from the calling
+      /// thread.
+      template <typename V, typename L, typename F>
+      image2d<L>
+      runs(const image2d<V>& input, const neighb2d& nbh,
+	   L& nlabels, F& functor, unsigned nthreads);
+
+
+      namespace internal
+      {
+
+	/// A horizontal run of sites.
+	struct run
+	{
+	  int row;
+	  int begin; ///< First column.
+	  int end;   ///< Past-the-end column.
+	};
+
+
+	/*! \brief Extract the runs of the sites handled by \p f and
+	  merge the connected ones.
+
+	  The runs are sorted in the forward order. \p parent is a
+	  union-find forest on the runs, in which the root of a
+	  component is its first run.
+	 */
+	template <typename V, typename F>
+	void
+	extract_runs(const image2d<V>& input, const F& f,
+		     unsigned connectivity, unsigned nthreads,
+		     std::vector<run>& runs, std::vector<unsigned>& parent);
+
+
+	/// Find the root of \p x, compressing the path.
+	unsigned
+	find_root_runs(std::vector<unsigned>& parent, unsigned x);
+
+
+	/// Return 4 or 8 if \p nbh is c4() or c8(), 0 otherwise.
+	unsigned
+	runs_connectivity(const neighb2d& nbh);
+
+
+	/// Label with runs() if possible, with video() otherwise.
+	template <typename I, typename N, typename L, typename F>
+	mln_ch_value(I, L)
+	runs_dispatch(const Image<I>& input, const Neighborhood<N>& nbh,
+		      L& nlabels, F& functor);
+
+      } // end of namespace mln::canvas::labeling::internal
+
+
+
+# ifndef MLN_INCLUDE_ONLY
+
+      namespace internal
+      {
+
+	/// Find the root of \p x, compressing the path.
+	inline
+	unsigned
+	find_root_runs(std::vector<unsigned>& parent, unsigned x)
+	{
+	  unsigned r = x;
+	  while (parent[r] != r)
+	    r = parent[r];
+
+	  while (parent[x] != r)
+	  {
+	    unsigned next = parent[x];
+	    parent[x] = r;
+	    x = next;
+	  }
+
+	  return r;
+	}
+
+
+	/// Merge the components of the runs \p a and \p b. The root is
+	/// the first run, so the one of the first site of the component.
+	inline
+	void
+	union_runs(std::vector<unsigned>& parent, unsigned a, unsigned b)
+	{
+	  a = find_root_runs(parent, a);
+	  b = find_root_runs(parent, b);
+	  if (a < b)
+	    parent[b] = a;
+	  else if (b < a)
+	    parent[a] = b;
+	}
+
+
+	inline
+	unsigned
+	runs_connectivity(const neighb2d& nbh)
+	{
+	  const window2d& win = nbh.win();
+	  const unsigned n = win.size();
+	  if (n != 4 && n != 8)
+	    return 0;
+
+	  for (unsigned i = 0; i < n; ++i)
+	  {
+	    const int
+	      drow = std::abs(win.dp(i).row()),
+	      dcol = std::abs(win.dp(i).col());
+	    if (drow > 1 || dcol > 1 || drow + dcol == 0
+		|| (n == 4 && drow + dcol != 1))
+	      return 0;
+	  }
+
+	  return n;
+	}
+
+
+	/// Merge the runs [\p cur_first, \p cur_last) with the
+	/// connected runs of [\p prev_first, \p prev_last), from the
+	/// previous row.
+	inline
+	void
+	link_runs(const std::vector<run>& runs, std::vector<unsigned>& parent,
+		  unsigned prev_first, unsigned prev_last,
+		  unsigned cur_first, unsigned cur_last, int reach)
+	{
+	  unsigned prev = prev_first;
+
+	  for (unsigned id = cur_first; id < cur_last; ++id)
+	  {
+	    const run& r = runs[id];
+
+	    // Skip the runs of the previous row ending before r.
+	    while (prev < prev_last && runs[prev].end + reach <= r.begin)
+	      ++prev;
+
+	    // Merge with the overlapping ones.
+	    for (unsigned q = prev;
+		 q < prev_last && runs[q].begin < r.end + reach; ++q)
+	      union_runs(parent, q, id);
+	  }
+	}
+
+
+	/// Extract and merge the runs of the rows [\p first_row,
+	/// \p end_row).
+	template <typename V, typename F>
+	inline
+	void
+	band_runs(const image2d<V>& input, const F& f,
+		  int first_row, int end_row, int reach,
+		  std::vector<run>& runs, std::vector<unsigned>& parent)
+	{
+	  const int
+	    min_col = input.domain().pmin().col(),
+	    ncols = input.domain().ncols();
+
+	  unsigned prev_first = 0, prev_last = 0;
+
+	  for (int row = first_row; row < end_row; ++row)
+	  {
+	    const unsigned p_row = input.index_of_point(point2d(row, min_col));
+	    const unsigned cur_first = runs.size();
+
+	    for (int col = 0; col < ncols; )
+	    {
+	      if (! f.handles_(p_row + col))
+	      {
+		++col;
+		continue;
+	      }
+
+	      run r;
+	      r.row = row;
+	      r.begin = min_col + col;
+	      while (col < ncols && f.handles_(p_row + col))
+		++col;
+	      r.end = min_col + col;
+
+	      parent.push_back(runs.size());
+	      runs.push_back(r);
+	    }
+
+	    link_runs(runs, parent, prev_first, prev_last,
+		      cur_first, runs.size(), reach);
+
+	    prev_first = cur_first;
+	    prev_last = runs.size();
+	  }
+	}
+
+
+	template <typename V, typename F>
+	inline
+	void
+	extract_runs(const image2d<V>& input, const F& f,
+		     unsigned connectivity, unsigned nthreads,
+		     std::vector<run>& runs, std::vector<unsigned>& parent)
+	{
+	  // With c8, runs touching by a corner are connected.
+	  const int reach = connectivity == 8 ? 1 : 0;
+
+	  const int
+	    min_row = input.domain().pmin().row(),
+	    nrows = input.domain().nrows(),
+	    nbands = std::min(nthreads > 1 ? int(4 * nthreads) : 1, nrows);
+
+	  if (nbands <= 1)
+	  {
+	    band_runs(input, f, min_row, min_row + nrows, reach, runs, parent);
+	    return;
+	  }
+
+	  std::vector< std::vector<run> > band_runs_(nbands);
+	  std::vector< std::vector<unsigned> > band_parent(nbands);
+
+#  ifdef _OPENMP
+#   pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+#  endif // ! _OPENMP
+	  for (int i = 0; i < nbands; ++i)
+	    band_runs(input, f,
+		      min_row + i * nrows / nbands,
+		      min_row + (i + 1) * nrows / nbands,
+		      reach, band_runs_[i], band_parent[i]);
+
+	  // Concatenate the bands and merge the runs across their
+	  // boundaries.
+	  unsigned prev_first = 0, prev_last = 0;
+	  for (int i = 0; i < nbands; ++i)
+	  {
+	    const unsigned offset = runs.size();
+	    const int
+	      first_row = min_row + i * nrows / nbands,
+	      last_row = min_row + (i + 1) * nrows / nbands - 1;
+
+	    runs.insert(runs.end(), band_runs_[i].begin(), band_runs_[i].end());
+	    for (unsigned j = 0; j < band_parent[i].size(); ++j)
+	      parent.push_back(band_parent[i][j] + offset);
+	    std::vector<run>().swap(band_runs_[i]);
+	    std::vector<unsigned>().swap(band_parent[i]);
+
+	    unsigned cur_last = offset;
+	    while (cur_last < runs.size() && runs[cur_last].row == first_row)
+	      ++cur_last;
+	    link_runs(runs, parent, prev_first, prev_last,
+		      offset, cur_last, reach);
+
+	    prev_last = runs.size();
+	    prev_first = prev_last;
+	    while (prev_first > offset && runs[prev_first - 1].row == last_row)
+	      --prev_first;
+	  }
+	}
+
+
+	template <typename I, typename N, typename L, typename F>
+	inline
+	mln_ch_value(I, L)
+	runs_dispatch(const Image<I>& input, const Neighborhood<N>& nbh,
+		      L& nlabels, F& functor)
+	{
+	  return video(input, nbh, nlabels, functor);
+	}
+
+
+	template <typename V, typename L, typename F>
+	inline
+	image2d<L>
+	runs_dispatch(const Image< image2d<V> >& input,
+		      const Neighborhood<neighb2d>& nbh,
+		      L& nlabels, F& functor)
+	{
+	  if (runs_connectivity(exact(nbh)) == 0)
+	    return video(input, nbh, nlabels, functor);
+
+	  return runs(exact(input), exact(nbh), nlabels, functor);
+	}
+
+      } // end of namespace mln::canvas::labeling::internal
+
+
+      template <typename V, typename L, typename F>
+      image2d<L>
+      runs(const image2d<V>& input, const neighb2d& nbh,
+	   L& nlabels, F& f, unsigned nthreads)
+      {
+	trace::entering("canvas::labeling::runs");
+
+	internal::labeling_tests(input, nbh, nlabels, f);
+	const unsigned connectivity = internal::runs_connectivity(nbh);
+	mln_precondition(connectivity != 0);
+
+	image2d<L> output;
+	initialize(output, input);
+	mln::data::fill(output, L(literal::zero));
+	nlabels = 0;
+
+	f.init_(); // Client initialization.
+
+	// First pass: runs and union-find.
+	std::vector<internal::run> runs;
+	std::vector<unsigned> parent;
+	internal::extract_runs(input, f, connectivity, nthreads, runs, parent);
+
+	// Second pass: labels, in the order of the first runs.
+	{
+	  std::vector<L> run_label(runs.size());
+
+	  for (unsigned i = 0; i < runs.size(); ++i)
+	  {
+	    const internal::run& r = runs[i];
+	    const unsigned p = input.index_of_point(point2d(r.row, r.begin));
+	    unsigned first = p;
+
+	    if (parent[i] == i) // if i is a root
+	    {
+	      L lbl = L(literal::zero);
+	      if (f.labels_(first))
+	      {
+		if (nlabels == mln_max(L))
+		{
+		  trace::warning("labeling aborted! Too many labels for \
+					this label type: nlabels > \
+					max(label_type).");
+		  trace::exiting("canvas::labeling::runs");
+		  return output;
+		}
+		lbl = ++nlabels;
+		f.set_new_label_(first, lbl);
+	      }
+	      run_label[i] = lbl;
+	      ++first;
+	    }
+	    else
+	      run_label[i] = run_label[internal::find_root_runs(parent, i)];
+
+	    const L lbl = run_label[i];
+	    L* out = &output.at_(r.row, r.begin);
+	    std::fill(out, out + r.end - r.begin, lbl);
+
+	    for (unsigned q = first; q < p + r.end - r.begin; ++q)
+	      f.set_label_(q, lbl);
+	  }
+	}
+
+	f.finalize();
+	trace::exiting("canvas::labeling::runs");
+	return output;
+      }
+
+
+      template <typename V, typename L, typename F>
+      inline
+      image2d<L>
+      runs(const image2d<V>& input, const neighb2d& nbh,
+	   L& nlabels, F& functor)
+      {
+	return runs(input, nbh, nlabels, functor, 1);
+      }
+
+# endif // ! MLN_INCLUDE_ONLY
+
+    } // end of namespace mln::canvas::labeling
+
+  } // end of namespace mln::canvas
+
+} // end of namespace mln
+
+
+#endif // ! MLN_CANVAS_LABELING_RUNS_HH
@@ -57,6 +57,7 @@
 # include <mln/core/image/image1d.hh>
 # include <mln/core/image/image2d.hh>
 # include <mln/core/image/image3d.hh>
+# include <mln/core/image/packed_image2d.hh>
 # include <mln/core/image/vertex_image.hh>
 
 
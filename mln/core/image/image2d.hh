@@ -69,11 +69,16 @@ namespace mln
     struct data< image2d<T> >
     {
       data(const box2d& b, unsigned bdr);
+      data(const box2d& b, T* buffer);
       ~data();
 
       T*  buffer_;
       T** array_;
 
+      /// False if buffer_ is provided by the user and must not be
+      /// freed.
+      bool own_buffer_;
+
       box2d b_;  // theoretical box
       unsigned bdr_;
       box2d vb_; // virtual box, i.e., box including the virtual border
@@ -162,6 +167,13 @@ namespace mln
     /// 3).
     image2d(const box2d& b, unsigned bdr = border::thickness);
 
+    /// Constructor on an existing \p buffer of \p b.nrows() rows of
+    /// \p b.ncols() contiguous values, without border.
+    ///
+    /// The buffer is neither copied nor freed: it must outlive this
+    /// image and all its copies.
+    image2d(T* buffer, const box2d& b);
+
 
     /// Initialize an empty image.
     void init_(const box2d& b, unsigned bdr = border::thickness);
@@ -298,12 +310,25 @@ namespace mln
     data< image2d<T> >::data(const box2d& b, unsigned bdr)
       : buffer_(0),
 	array_ (0),
+	own_buffer_(true),
 	b_     (b),
 	bdr_   (bdr)
     {
       allocate_();
     }
 
+    template <typename T>
+    inline
+    data< image2d<T> >::data(const box2d& b, T* buffer)
+      : buffer_(buffer),
+	array_ (0),
+	own_buffer_(false),
+	b_     (b),
+	bdr_   (0)
+    {
+      allocate_();
+    }
+
     template <typename T>
     inline
     data< image2d<T> >::~data()
@@ -329,7 +354,8 @@ namespace mln
       unsigned
 	nr = vb_.len(0),
 	nc = vb_.len(1);
-      buffer_ = new T[nr * nc];
+      if (own_buffer_)
+	buffer_ = new T[nr * nc];
       array_ = new T*[nr];
       T* buf = buffer_ - vb_.pmin().col();
       for (unsigned i = 0; i < nr; ++i)
@@ -349,7 +375,8 @@ namespace mln
     {
       if (buffer_)
 	{
-	  delete[] buffer_;
+	  if (own_buffer_)
+	    delete[] buffer_;
 	  buffer_ = 0;
 	}
       if (array_)
@@ -405,6 +432,14 @@ namespace mln
     init_(b, bdr);
   }
 
+  template <typename T>
+  inline
+  image2d<T>::image2d(T* buffer, const box2d& b)
+  {
+    mln_precondition(buffer != 0);
+    this->data_ = new internal::data< image2d<T> >(b, buffer);
+  }
+
   template <typename T>
   inline
   void
@@ -0,0 +1,548 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+#ifndef MLN_CORE_IMAGE_PACKED_IMAGE2D_HH
+# define MLN_CORE_IMAGE_PACKED_IMAGE2D_HH
+
+/// \file
+///
+/// Definition of a 2D binary image storing one bit per site.
+
+# include <cstring>
+
+# include <mln/core/internal/image_primary.hh>
+# include <mln/core/alias/box2d.hh>
+# include <mln/core/routine/init.hh>
+
+# include <mln/border/thickness.hh>
+# include <mln/value/proxy.hh>
+# include <mln/value/set.hh>
+
+
+
+namespace mln
+{
+
+  // Forward declarations.
+  class packed_image2d;
+  template <typename T> struct image2d;
+
+
+  namespace internal
+  {
+
+    /// Data structure for \c mln::packed_image2d.
+    template <>
+    struct data< packed_image2d >
+    {
+      /// Type of the memory words holding the bits.
+      typedef unsigned long word;
+
+      data(const box2d& b);
+      ~data();
+
+      box2d b_;
+
+      /// Number of words per row.
+      unsigned nwords_;
+
+      /// Rows of \c nwords_ words; the bits beyond the last column
+      /// are always 0.
+      word* buffer_;
+
+    private:
+      data(const data&);
+      void operator=(const data&);
+    };
+
+  } // end of namespace mln::internal
+
+
+  namespace trait
+  {
+
+    template <>
+    struct image_< packed_image2d > : default_image_< bool, packed_image2d >
+    {
+      // misc
+      typedef trait::image::category::primary category;
+      typedef trait::image::speed::fast       speed;
+      typedef trait::image::size::regular     size;
+
+      // value
+      typedef trait::image::vw_io::none                    vw_io;
+      typedef trait::image::vw_set::none                   vw_set;
+      typedef trait::image::value_access::computed         value_access;
+      typedef trait::image::value_storage::disrupted       value_storage;
+      typedef trait::image::value_browsing::site_wise_only value_browsing;
+      typedef trait::image::value_alignment::with_grid     value_alignment;
+      typedef trait::image::value_io::read_write           value_io;
+
+      // site / domain
+      typedef trait::image::pw_io::read_write        pw_io;
+      typedef trait::image::localization::basic_grid localization;
+      typedef trait::image::dimension::two_d         dimension;
+
+      // extended domain
+      typedef trait::image::ext_domain::none      ext_domain;
+      typedef trait::image::ext_value::irrelevant ext_value;
+      typedef trait::image::ext_io::irrelevant    ext_io;
+    };
+
+  } // end of namespace mln::trait
+
+
+
+  /// 2D binary image storing one bit per site.
+  ///
+  /// Each row is stored in whole memory words, column \c c of a row
+  /// being the bit <tt>c % nbits</tt> of its word <tt>c / nbits</tt>
+  /// (columns are counted from the first column of the domain).
+  /// The bits beyond the last column are always 0 so that the
+  /// algorithms can work on whole words; this image has no border.
+  ///
+  /// Values are written through a proxy; use row_words() to process
+  /// a row several sites at a time.
+  ///
+  /// \ingroup modimageconcrete
+  //
+  class packed_image2d
+    : public internal::image_primary< bool, mln::box2d, packed_image2d >
+  {
+  public:
+
+    /// Value associated type.
+    typedef bool value;
+
+    /// Return type of read-only access.
+    typedef bool rvalue;
+
+    /// Return type of read-write access.
+    typedef mln::value::proxy<packed_image2d> lvalue;
+
+    /// Type of the memory words holding the bits.
+    typedef internal::data< packed_image2d >::word word;
+
+    /// Number of bits per memory word.
+    enum { nbits = 8 * sizeof(word) };
+
+
+    /// Skeleton.
+    typedef packed_image2d skeleton;
+
+
+    /// Constructor without argument.
+    packed_image2d();
+
+    /// Constructor with the numbers of rows and columns.
+    packed_image2d(int nrows, int ncols);
+
+    /// Constructor with a box.
+    packed_image2d(const box2d& b);
+
+
+    /// Initialize an empty image; every site is set to false.
+    void init_(const box2d& b);
+
+
+    /// Test if \p p is valid.
+    bool has(const point2d& p) const;
+
+    /// Give the definition domain.
+    const box2d& domain() const;
+
+    /// Give the bounding box domain.
+    const box2d& bbox() const;
+
+    /// Read-only access to the image value located at point \p p.
+    bool operator()(const point2d& p) const;
+
+    /// Read-write access to the image value located at point \p p.
+    lvalue operator()(const point2d& p);
+
+
+    /// Read the value located at point \p p.
+    bool read_(const point2d& p) const;
+
+    /// Write \p v at point \p p.
+    void write_(const point2d& p, bool v);
+
+
+    // Specific methods:
+    // -----------------
+
+    /// Read-only access to the image value located at (\p row, \p col).
+    bool at_(mln::def::coord row, mln::def::coord col) const;
+
+    /// Give the number of rows.
+    unsigned nrows() const;
+
+    /// Give the number of columns.
+    unsigned ncols() const;
+
+
+    // As a bit-packed image:
+    // ----------------------
+
+    /// Give the number of words per row.
+    unsigned nwords() const;
+
+    /// Give the mask of the bits used in the last word of a row.
+    word last_word_mask() const;
+
+    /// Give a hook to the words of the row \p row.
+    const word* row_words(mln::def::coord row) const;
+
+    /// Give a hook to the words of the row \p row.
+    word* row_words(mln::def::coord row);
+
+    /// Give a hook to the words of all the rows, stored one after
+    /// the other.
+    const word* buffer() const;
+
+    /// Give a hook to the words of all the rows, stored one after
+    /// the other.
+    word* buffer();
+  };
+
+
+
+  template <typename J>
+  void init_(tag::image_t, packed_image2d& target, const J& model);
+
+  /// Images initialized from a packed_image2d get the default
+  /// border, since it has none.
+  void init_(tag::border_t, unsigned& bdr, const packed_image2d& model);
+
+
+  namespace internal
+  {
+
+    /// Give the \p len bits (at most packed_image2d::nbits) of the
+    /// row \p w starting at bit \p c, in the low bits of the result.
+    packed_image2d::word packed_get_bits(const packed_image2d::word* w,
+					 unsigned c, unsigned len);
+
+    /// Overwrite the \p len bits (at most packed_image2d::nbits) of
+    /// the row \p w starting at bit \p c with the low bits of \p v.
+    void packed_set_bits(packed_image2d::word* w, unsigned c, unsigned len,
+			 packed_image2d::word v);
+
+    /// Give the number of bits set in \p w.
+    unsigned packed_popcount(packed_image2d::word w);
+
+  } // end of namespace mln::internal
+
+
+  namespace trait
+  {
+
+    namespace impl
+    {
+
+      /// Changing the value type of a packed_image2d gives an
+      /// image2d, except for bool.
+      template <typename V>
+      struct ch_value_< packed_image2d, V >
+      {
+	typedef image2d<V> ret;
+      };
+
+      template <>
+      struct ch_value_< packed_image2d, bool >
+      {
+	typedef packed_image2d ret;
+      };
+
+    } // end of namespace mln::trait::impl
+
+  } // end of namespace mln::trait
+
+
+
+# ifndef MLN_INCLUDE_ONLY
+
+  // init_
+
+  template <typename J>
+  inline
+  void init_(tag::image_t, packed_image2d& target, const J& model)
+  {
+    box2d b;
+    init_(tag::bbox, b, model);
+    target.init_(b);
+  }
+
+  inline
+  void init_(tag::border_t, unsigned& bdr, const packed_image2d&)
+  {
+    bdr = border::thickness;
+  }
+
+
+  // internal::data< packed_image2d >
+
+  namespace internal
+  {
+
+    inline
+    packed_image2d::word packed_get_bits(const packed_image2d::word* w,
+					 unsigned c, unsigned len)
+    {
+      typedef packed_image2d::word word;
+      const unsigned nbits = packed_image2d::nbits;
+      mln_precondition(len > 0 && len <= nbits);
+      unsigned k = c / nbits, b = c % nbits;
+      word v = w[k] >> b;
+      if (b != 0 && b + len > nbits)
+	v |= w[k + 1] << (nbits - b);
+      if (len < nbits)
+	v &= (word(1) << len) - 1;
+      return v;
+    }
+
+    inline
+    void packed_set_bits(packed_image2d::word* w, unsigned c, unsigned len,
+			 packed_image2d::word v)
+    {
+      typedef packed_image2d::word word;
+      const unsigned nbits = packed_image2d::nbits;
+      mln_precondition(len > 0 && len <= nbits);
+      word mask = len < nbits ? (word(1) << len) - 1 : ~word(0);
+      v &= mask;
+      unsigned k = c / nbits, b = c % nbits;
+      w[k] = (w[k] & ~(mask << b)) | (v << b);
+      if (b != 0 && b + len > nbits)
+	w[k + 1] = (w[k + 1] & ~(mask >> (nbits - b))) | (v >> (nbits - b));
+    }
+
+    inline
+    unsigned packed_popcount(packed_image2d::word w)
+    {
+# if defined(__GNUC__)
+      return __builtin_popcountl(w);
+# else
+      unsigned n = 0;
+      for (; w; w &= w - 1)
+	++n;
+      return n;
+# endif
+    }
+
+
+    inline
+    data< packed_image2d >::data(const box2d& b)
+      : b_(b)
+    {
+      const unsigned nbits = 8 * sizeof(word);
+      nwords_ = (b.len(1) + nbits - 1) / nbits;
+      unsigned n = b.len(0) * nwords_;
+      buffer_ = new word[n];
+      std::memset(buffer_, 0, n * sizeof(word));
+    }
+
+    inline
+    data< packed_image2d >::~data()
+    {
+      delete[] buffer_;
+    }
+
+  } // end of namespace mln::internal
+
+
+  // packed_image2d
+
+  inline
+  packed_image2d::packed_image2d()
+  {
+  }
+
+  inline
+  packed_image2d::packed_image2d(int nrows, int ncols)
+  {
+    init_(make::box2d(nrows, ncols));
+  }
+
+  inline
+  packed_image2d::packed_image2d(const box2d& b)
+  {
+    init_(b);
+  }
+
+  inline
+  void
+  packed_image2d::init_(const box2d& b)
+  {
+    mln_precondition(! this->is_valid());
+    this->data_ = new internal::data< packed_image2d >(b);
+  }
+
+  inline
+  bool
+  packed_image2d::has(const point2d& p) const
+  {
+    mln_precondition(this->is_valid());
+    return this->data_->b_.has(p);
+  }
+
+  inline
+  const box2d&
+  packed_image2d::domain() const
+  {
+    mln_precondition(this->is_valid());
+    return this->data_->b_;
+  }
+
+  inline
+  const box2d&
+  packed_image2d::bbox() const
+  {
+    mln_precondition(this->is_valid());
+    return this->data_->b_;
+  }
+
+  inline
+  bool
+  packed_image2d::operator()(const point2d& p) const
+  {
+    return read_(p);
+  }
+
+  inline
+  packed_image2d::lvalue
+  packed_image2d::operator()(const point2d& p)
+  {
+    mln_precondition(this->has(p));
+    return lvalue(*this, p);
+  }
+
+  inline
+  bool
+  packed_image2d::read_(const point2d& p) const
+  {
+    mln_precondition(this->has(p));
+    return at_(p.row(), p.col());
+  }
+
+  inline
+  void
+  packed_image2d::write_(const point2d& p, bool v)
+  {
+    mln_precondition(this->has(p));
+    unsigned c = p.col() - this->data_->b_.pmin().col();
+    word& w = row_words(p.row())[c / nbits];
+    const word bit = word(1) << (c % nbits);
+    if (v)
+      w |= bit;
+    else
+      w &= ~bit;
+  }
+
+  inline
+  bool
+  packed_image2d::at_(mln::def::coord row, mln::def::coord col) const
+  {
+    mln_precondition(this->has(point2d(row, col)));
+    unsigned c = col - this->data_->b_.pmin().col();
+    return (row_words(row)[c / nbits] >> (c % nbits)) & 1;
+  }
+
+  inline
+  unsigned
+  packed_image2d::nrows() const
+  {
+    mln_precondition(this->is_valid());
+    return this->data_->b_.len(0);
+  }
+
+  inline
+  unsigned
+  packed_image2d::ncols() const
+  {
+    mln_precondition(this->is_valid());
+    return this->data_->b_.len(1);
+  }
+
+  inline
+  unsigned
+  packed_image2d::nwords() const
+  {
+    mln_precondition(this->is_valid());
+    return this->data_->nwords_;
+  }
+
+  inline
+  packed_image2d::word
+  packed_image2d::last_word_mask() const
+  {
+    mln_precondition(this->is_valid());
+    unsigned used = ncols() % nbits;
+    return used ? (word(1) << used) - 1 : ~word(0);
+  }
+
+  inline
+  const packed_image2d::word*
+  packed_image2d::row_words(mln::def::coord row) const
+  {
+    mln_precondition(this->is_valid());
+    mln_precondition(row >= this->data_->b_.pmin().row()
+		     && row <= this->data_->b_.pmax().row());
+    return this->data_->buffer_
+      + (row - this->data_->b_.pmin().row()) * this->data_->nwords_;
+  }
+
+  inline
+  packed_image2d::word*
+  packed_image2d::row_words(mln::def::coord row)
+  {
+    mln_precondition(this->is_valid());
+    mln_precondition(row >= this->data_->b_.pmin().row()
+		     && row <= this->data_->b_.pmax().row());
+    return this->data_->buffer_
+      + (row - this->data_->b_.pmin().row()) * this->data_->nwords_;
+  }
+
+  inline
+  const packed_image2d::word*
+  packed_image2d::buffer() const
+  {
+    mln_precondition(this->is_valid());
+    return this->data_->buffer_;
+  }
+
+  inline
+  packed_image2d::word*
+  packed_image2d::buffer()
+  {
+    mln_precondition(this->is_valid());
+    return this->data_->buffer_;
+  }
+
+# endif // ! MLN_INCLUDE_ONLY
+
+} // end of namespace mln
+
+
+#endif // ! MLN_CORE_IMAGE_PACKED_IMAGE2D_HH
@@ -34,6 +34,7 @@
 #  error "Forbidden inclusion of *.spe.hh"
 # endif // ! MLN_DATA_FILL_WITH_VALUE_HH
 
+# include <mln/core/image/packed_image2d.hh>
 # include <mln/data/memset_.hh>
 # include <mln/opt/value.hh>
 # include <mln/opt/element.hh>
@@ -129,6 +130,31 @@ namespace mln
 	trace::exiting("data::impl::fill_with_value_singleton");
       }
 
+      template <typename V>
+      inline
+      void fill_with_value_packed(packed_image2d& ima, const V& val)
+      {
+	trace::entering("data::impl::fill_with_value_packed");
+
+	internal::fill_with_value_tests(ima, val);
+
+	typedef packed_image2d::word word;
+	const unsigned nwords = ima.nwords();
+	word* w = ima.buffer();
+	if (! static_cast<bool>(exact(val)))
+	  std::memset(w, 0, ima.nrows() * nwords * sizeof(word));
+	else if (nwords != 0)
+	{
+	  std::memset(w, 0xff, ima.nrows() * nwords * sizeof(word));
+	  // Keep the bits beyond the last column to 0.
+	  const word last = ima.last_word_mask();
+	  for (unsigned r = 0; r < ima.nrows(); ++r, w += nwords)
+	    w[nwords - 1] &= last;
+	}
+
+	trace::exiting("data::impl::fill_with_value_packed");
+      }
+
     } // end of namespace mln::data::impl
 
 
@@ -207,6 +233,12 @@ namespace mln
                                  ima, val);
       }
 
+      template <typename V>
+      void fill_with_value_dispatch(Image<packed_image2d>& ima, const V& val)
+      {
+        impl::fill_with_value_packed(exact(ima), val);
+      }
+
     } // end of namespace mln::data::internal
 
 
@@ -35,7 +35,10 @@
 #  error "Forbidden inclusion of *.spe.hh"
 # endif // ! MLN_DATA_PASTE_HH
 
+# include <algorithm>
+
 # include <mln/core/pixel.hh>
+# include <mln/core/image/packed_image2d.hh>
 # include <mln/data/fill_with_value.hh>
 # include <mln/data/memcpy_.hh>
 # include <mln/core/box_runstart_piter.hh>
@@ -136,6 +139,100 @@ namespace mln
 	trace::exiting("data::impl::paste_lines");
       }
 
+      inline
+      void paste_packed(const packed_image2d& input, packed_image2d& output)
+      {
+        trace::entering("data::impl::paste_packed");
+
+        data::internal::paste_tests(input, output);
+
+        typedef packed_image2d::word word;
+        const unsigned nbits = packed_image2d::nbits;
+        const box2d& b = input.domain();
+
+        if (b == output.domain())
+          std::memcpy(output.buffer(), input.buffer(),
+                      input.nrows() * input.nwords() * sizeof(word));
+        else
+        {
+          const unsigned
+            ncols = input.ncols(),
+            shift = b.pmin().col() - output.domain().pmin().col();
+          for (def::coord row = b.pmin().row(); row <= b.pmax().row(); ++row)
+          {
+            const word* in = input.row_words(row);
+            word* out = output.row_words(row);
+            for (unsigned c = 0; c < ncols; c += nbits)
+              mln::internal::packed_set_bits(out, shift + c,
+                                             std::min(nbits, ncols - c),
+                                             in[c / nbits]);
+          }
+        }
+
+        trace::exiting("data::impl::paste_packed");
+      }
+
+      template <typename T>
+      inline
+      void paste_packed(const image2d<T>& input, packed_image2d& output)
+      {
+        trace::entering("data::impl::paste_packed");
+
+        data::internal::paste_tests(input, output);
+
+        typedef packed_image2d::word word;
+        const unsigned nbits = packed_image2d::nbits;
+        const box2d& b = input.domain();
+        const unsigned
+          ncols = input.ncols(),
+          shift = b.pmin().col() - output.domain().pmin().col();
+
+        for (def::coord row = b.pmin().row(); row <= b.pmax().row(); ++row)
+        {
+          const T* in = &input.at_(row, b.pmin().col());
+          word* out = output.row_words(row);
+          for (unsigned c = 0; c < ncols; c += nbits)
+          {
+            const unsigned len = std::min(nbits, ncols - c);
+            word w = 0;
+            for (unsigned i = 0; i < len; ++i)
+              w |= word(static_cast<bool>(in[c + i])) << i;
+            mln::internal::packed_set_bits(out, shift + c, len, w);
+          }
+        }
+
+        trace::exiting("data::impl::paste_packed");
+      }
+
+      template <typename T>
+      inline
+      void paste_packed(const packed_image2d& input, image2d<T>& output)
+      {
+        trace::entering("data::impl::paste_packed");
+
+        data::internal::paste_tests(input, output);
+
+        typedef packed_image2d::word word;
+        const unsigned nbits = packed_image2d::nbits;
+        const box2d& b = input.domain();
+        const unsigned ncols = input.ncols();
+
+        for (def::coord row = b.pmin().row(); row <= b.pmax().row(); ++row)
+        {
+          const word* in = input.row_words(row);
+          T* out = &output.at_(row, b.pmin().col());
+          for (unsigned c = 0; c < ncols; c += nbits)
+          {
+            const unsigned len = std::min(nbits, ncols - c);
+            const word w = in[c / nbits];
+            for (unsigned i = 0; i < len; ++i)
+              out[c + i] = static_cast<T>(bool((w >> i) & 1));
+          }
+        }
+
+        trace::exiting("data::impl::paste_packed");
+      }
+
       template <typename I, typename J>
       void paste_singleton(const Image<I>& input_, Image<J>& output_)
       {
@@ -313,6 +410,31 @@ namespace mln
 		       input, output);
       }
 
+      // Word-level versions for packed_image2d.
+
+      inline
+      void paste_dispatch(const Image<packed_image2d>& input,
+			  Image<packed_image2d>& output)
+      {
+        impl::paste_packed(exact(input), exact(output));
+      }
+
+      template <typename T>
+      inline
+      void paste_dispatch(const Image< image2d<T> >& input,
+			  Image<packed_image2d>& output)
+      {
+        impl::paste_packed(exact(input), exact(output));
+      }
+
+      template <typename T>
+      inline
+      void paste_dispatch(const Image<packed_image2d>& input,
+			  Image< image2d<T> >& output)
+      {
+        impl::paste_packed(exact(input), exact(output));
+      }
+
     } // end of namespace mln::data::internal
 
   } // end of namespace mln::data
@@ -32,6 +32,8 @@
 
 # include <mln/core/concept/accumulator.hh>
 # include <mln/core/concept/image.hh>
+# include <mln/core/image/packed_image2d.hh>
+# include <mln/accu/count_value.hh>
 
 
 
@@ -143,6 +145,31 @@ namespace mln
       }
 
 
+      /// Word-level count of the sites of a packed_image2d equal to
+      /// the value counted by \p a.
+      inline
+      unsigned
+      update_packed(accu::count_value<bool>& a, const packed_image2d& input)
+      {
+	trace::entering("data::impl::update_packed");
+
+	data::internal::update_tests(a, input);
+
+	// The bits beyond the last column are 0 so every word can be
+	// counted whole.
+	const unsigned n = input.nrows() * input.nwords();
+	const packed_image2d::word* w = input.buffer();
+	unsigned count = 0;
+	for (unsigned i = 0; i < n; ++i)
+	  count += mln::internal::packed_popcount(w[i]);
+	if (! a.ref())
+	  count = input.nrows() * input.ncols() - count;
+	a.set_value(a.to_result() + count);
+
+	trace::exiting("data::impl::update_packed");
+	return a.to_result();
+      }
+
     } // end of namespace mln::data::impl
 
 
@@ -179,6 +206,14 @@ namespace mln
 			       a, input);
       }
 
+      inline
+      unsigned
+      update_dispatch(Accumulator< accu::count_value<bool> >& a,
+		      const Image<packed_image2d>& input)
+      {
+	return impl::update_packed(exact(a), exact(input));
+      }
+
     } // end of namespace internal
 
 
@@ -49,6 +49,13 @@ namespace mln
     template <typename I>
     histo::array<mln_value(I)> compute(const Image<I>& input);
 
+    /// \overload
+    /// The histograms of 8-bit 2D images are computed on
+    /// \p nthreads threads if OpenMP is available.
+    template <typename I>
+    histo::array<mln_value(I)> compute(const Image<I>& input,
+				       unsigned nthreads);
+
 
 # ifndef MLN_INCLUDE_ONLY
 
@@ -89,6 +96,22 @@ namespace mln
       return h;
     }
 
+    template <typename I>
+    inline
+    histo::array<mln_value(I)> compute(const Image<I>& input,
+				       unsigned nthreads)
+    {
+      trace::entering("histo::compute");
+      mlc_equal(mln_trait_image_quant(I), mln::trait::image::quant::low)::check();
+      mln_precondition(exact(input).is_valid());
+
+      histo::array<mln_value(I)> h = impl::compute_(mln_trait_image_speed(I)(),
+						    exact(input), nthreads);
+
+      trace::exiting("histo::compute");
+      return h;
+    }
+
 # endif // ! MLN_INCLUDE_ONLY
 
   } // end of namespace mln::histo
@@ -36,6 +36,12 @@
 # endif // ! MLN_HISTO_COMPUTE_HH
 
 
+# include <vector>
+
+# include <mln/core/image/image2d.hh>
+# include <mln/value/int_u8.hh>
+
+
 # ifndef MLN_INCLUDE_ONLY
 
 namespace mln
@@ -73,6 +79,170 @@ namespace mln
 	return h;
       }
 
+
+      /// Number of interleaved sub-histograms used to count values
+      /// with \p nvalues bins.
+      inline
+      unsigned
+      count_ways(unsigned nvalues)
+      {
+	// Beyond 8-bit values, the sub-histograms no longer fit in
+	// the L1 cache.
+	return nvalues <= 256 ? 4 : 1;
+      }
+
+
+      /// Count the \p n values of \p v into the \p ways interleaved
+      /// sub-histograms of \p nvalues bins starting at \p h.
+      ///
+      /// Consecutive pixels of a document often have the same value:
+      /// with several sub-histograms, their increments do not wait on
+      /// each other.
+      template <typename E>
+      inline
+      void
+      count_values(const E* v, unsigned n, unsigned* h,
+		   unsigned nvalues, unsigned ways)
+      {
+	unsigned i = 0;
+
+	if (ways == 4)
+	{
+	  unsigned
+	    *h1 = h + nvalues,
+	    *h2 = h1 + nvalues,
+	    *h3 = h2 + nvalues;
+
+	  for (; i + 4 <= n; i += 4)
+	  {
+	    ++h[v[i]];
+	    ++h1[v[i + 1]];
+	    ++h2[v[i + 2]];
+	    ++h3[v[i + 3]];
+	  }
+	}
+
+	for (; i < n; ++i)
+	  ++h[v[i]];
+      }
+
+
+      /// Count the values of a row of an image2d of low quantized
+      /// unsigned integers.  Rows are numbered from 0 whatever the
+      /// domain of the image.
+      template <typename V>
+      struct count_image2d_row
+      {
+	typedef mln_enc(V) E;
+
+	count_image2d_row(const image2d<V>& input)
+	  : input_(input),
+	    pmin_(input.domain().pmin())
+	{
+	}
+
+	void operator()(int row, unsigned* h,
+			unsigned nvalues, unsigned ways) const
+	{
+	  const E* v = reinterpret_cast<const E*>(
+	    & input_.at_(pmin_.row() + row, pmin_.col()));
+	  count_values(v, input_.ncols(), h, nvalues, ways);
+	}
+
+	const image2d<V>& input_;
+	point2d pmin_;
+      };
+
+
+      /*! \brief Compute a histogram row by row.
+
+        \param[in] nrows     The number of rows.
+        \param[in] count_row A functor such as count_row(row, h,
+                             nvalues, ways) counts the values of the
+                             row \p row into the \p ways interleaved
+                             sub-histograms of \p nvalues bins
+                             starting at \p h.
+        \param[in] nthreads  The number of threads.
+
+        With OpenMP, the rows are split between \p nthreads threads,
+        each one counting into its own sub-histograms, which are
+        merged at the end.
+       */
+      template <typename T, typename F>
+      inline
+      array<T>
+      compute_by_rows(int nrows, const F& count_row, unsigned nthreads)
+      {
+	array<T> h;
+
+	const unsigned
+	  nvalues = h.nvalues(),
+	  ways = count_ways(nvalues);
+	std::vector<unsigned> sub(ways * nvalues, 0);
+
+#  ifdef _OPENMP
+#   pragma omp parallel num_threads(nthreads)
+#  else
+	(void) nthreads;
+#  endif // ! _OPENMP
+	{
+	  std::vector<unsigned> sub_t(ways * nvalues, 0);
+
+#  ifdef _OPENMP
+#   pragma omp for schedule(static)
+#  endif // ! _OPENMP
+	  for (int row = 0; row < nrows; ++row)
+	    count_row(row, &sub_t[0], nvalues, ways);
+
+#  ifdef _OPENMP
+#   pragma omp critical (mln_histo_compute_by_rows)
+#  endif // ! _OPENMP
+	  for (unsigned i = 0; i < sub.size(); ++i)
+	    sub[i] += sub_t[i];
+	}
+
+	for (unsigned w = 0; w < ways; ++w)
+	  for (unsigned i = 0; i < nvalues; ++i)
+	    h[i] += sub[w * nvalues + i];
+
+	return h;
+      }
+
+
+      template <typename V>
+      inline
+      array<V>
+      compute_image2d_(const image2d<V>& input, unsigned nthreads)
+      {
+	return compute_by_rows<V>(input.nrows(),
+				  count_image2d_row<V>(input),
+				  nthreads);
+      }
+
+
+      template <typename I>
+      inline
+      array<mln_value(I)>
+      compute_(trait::image::speed::any, const I& input, unsigned)
+      {
+	return compute_(mln_trait_image_speed(I)(), input);
+      }
+
+      inline
+      array<value::int_u8>
+      compute_(trait::image::speed::fastest,
+	       const image2d<value::int_u8>& input, unsigned nthreads)
+      {
+	return compute_image2d_(input, nthreads);
+      }
+
+      inline
+      array<value::int_u8>
+      compute_(trait::image::speed::fastest,
+	       const image2d<value::int_u8>& input)
+      {
+	return compute_image2d_(input, 1);
+      }
     } // end of namespace mln::histo::impl
 
   } // end of namespace mln::histo
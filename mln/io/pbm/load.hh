@@ -35,9 +35,11 @@
 # include <iostream>
 # include <fstream>
 # include <string>
+# include <vector>
 
 # include <mln/core/image/image2d.hh>
 # include <mln/core/image/image3d.hh>
+# include <mln/core/image/packed_image2d.hh>
 # include <mln/io/pnm/load_header.hh>
 
 
@@ -68,6 +70,15 @@ namespace mln
       ///
       image2d<bool> load(const std::string& filename);
 
+      /// Load a pbm image in a packed_image2d.
+      ///
+      /// \param[out] ima A reference to the packed_image2d which will
+      /// receive data.
+      /// \param[in] filename The source.
+      ///
+      void load(packed_image2d& ima,
+		const std::string& filename);
+
 
 # ifndef MLN_INCLUDE_ONLY
 
@@ -121,6 +132,48 @@ namespace mln
 	}
 
 
+	/// Give the byte \p c with its bits in reverse order.
+	inline
+	unsigned char reverse_bits(unsigned char c)
+	{
+	  c = static_cast<unsigned char>(((c & 0xF0) >> 4) | ((c & 0x0F) << 4));
+	  c = static_cast<unsigned char>(((c & 0xCC) >> 2) | ((c & 0x33) << 2));
+	  c = static_cast<unsigned char>(((c & 0xAA) >> 1) | ((c & 0x55) << 1));
+	  return c;
+	}
+
+
+	/// load_raw_2d, word-level version for packed_image2d.
+	inline
+	void load_raw_2d(std::ifstream& file, packed_image2d& ima)
+	{
+	  typedef packed_image2d::word word;
+	  const unsigned
+	    nbytes = (ima.ncols() + 7) / 8,
+	    nwords = ima.nwords();
+	  std::vector<unsigned char> bytes(nwords * sizeof(word), 0);
+	  const word last = ima.last_word_mask();
+
+	  for (def::coord row = geom::min_row(ima);
+	       row <= geom::max_row(ima); ++row)
+	  {
+	    file.read((char*)(&bytes[0]), nbytes);
+	    word* w = ima.row_words(row);
+	    for (unsigned i = 0; i < nwords; ++i)
+	    {
+	      // In pbm, the first column is the highest bit of a byte
+	      // and '0' means 'true'.
+	      word v = 0;
+	      for (unsigned j = 0; j < sizeof(word); ++j)
+		v |= word(reverse_bits(static_cast<unsigned char>(
+					  ~bytes[i * sizeof(word) + j])))
+		  << (8 * j);
+	      w[i] = v;
+	    }
+	    w[nwords - 1] &= last;
+	  }
+	}
+
       } // end of namespace mln::io::internal
 
 
@@ -160,6 +213,37 @@ namespace mln
       }
 
 
+      inline
+      void load(packed_image2d& ima,
+		const std::string& filename)
+      {
+	trace::entering("mln::io::pbm::load");
+	std::ifstream file(filename.c_str());
+	if (! file)
+	{
+	  std::cerr << "error: file '" << filename
+		    << "' not found!";
+	  abort();
+	}
+	char type;
+	int nrows, ncols;
+	io::pnm::read_header('1', '4', file, type, nrows, ncols);
+
+	packed_image2d output(nrows, ncols);
+	if (type == '4')
+	{
+	  if (ncols != 0)
+	    internal::load_raw_2d(file, output);
+	}
+	else
+	  if (type == '1')
+	    internal::load_ascii(file, output);
+	ima = output;
+
+	trace::exiting("mln::io::pbm::load");
+      }
+
+
 # endif // ! MLN_INCLUDE_ONLY
 
     } // end of namespace mln::io::pbm
@@ -33,7 +33,9 @@
 
 # include <iostream>
 # include <fstream>
+# include <vector>
 
+# include <mln/core/image/packed_image2d.hh>
 # include <mln/geom/size2d.hh>
 # include <mln/metal/equal.hh>
 # include <mln/metal/bexpr.hh>
@@ -110,6 +112,51 @@ namespace mln
 	  mln_postcondition(stride == 0);
 	}
 
+
+	/// Give the byte \p c with its bits in reverse order.
+	inline
+	unsigned char reverse_bits(unsigned char c)
+	{
+	  c = static_cast<unsigned char>(((c & 0xF0) >> 4) | ((c & 0x0F) << 4));
+	  c = static_cast<unsigned char>(((c & 0xCC) >> 2) | ((c & 0x33) << 2));
+	  c = static_cast<unsigned char>(((c & 0xAA) >> 1) | ((c & 0x55) << 1));
+	  return c;
+	}
+
+	/// Word-level version for packed_image2d.
+	inline
+	void save_(const packed_image2d& ima, const std::string& filename)
+	{
+	  typedef packed_image2d::word word;
+	  std::ofstream file(filename.c_str());
+
+	  io::pnm::save_header(PBM, ima, filename, file);
+
+	  const unsigned
+	    ncols = ima.ncols(),
+	    nbytes = (ncols + 7) / 8,
+	    nwords = ima.nwords();
+	  // The unused bits of the last byte of a row are written as 0.
+	  const unsigned char last =
+	    static_cast<unsigned char>(0xff << ((8 - ncols % 8) % 8));
+	  std::vector<unsigned char> bytes(nwords * sizeof(word));
+
+	  if (nbytes != 0)
+	    for (def::coord row = geom::min_row(ima);
+		 row <= geom::max_row(ima); ++row)
+	    {
+	      const word* w = ima.row_words(row);
+	      for (unsigned i = 0; i < nwords; ++i)
+		for (unsigned j = 0; j < sizeof(word); ++j)
+		  // In pbm, the first column is the highest bit of a
+		  // byte and '0' means 'true'.
+		  bytes[i * sizeof(word) + j] =
+		    reverse_bits(static_cast<unsigned char>(~(w[i] >> (8 * j))));
+	      bytes[nbytes - 1] &= last;
+	      file.write((const char*)(&bytes[0]), nbytes);
+	    }
+	}
+
       } // end of namespace mln::io::impl
 
 
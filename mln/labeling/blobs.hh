@@ -40,6 +40,8 @@
 # include <mln/core/concept/neighborhood.hh>
 
 # include <mln/canvas/labeling/blobs.hh>
+# include <mln/canvas/labeling/runs.hh>
+# include <mln/labeling/value.hh>
 
 
 namespace mln
@@ -90,6 +92,37 @@ namespace mln
 	void finalize() {}
       };
 
+
+      template <typename I, typename N, typename L>
+      inline
+      mln_ch_value(I, L)
+      blobs_dispatch(const I& input, const N& nbh, L& nlabels)
+      {
+	typedef mln_ch_value(I,L) out_t;
+	internal::dummy_functor<out_t> functor;
+	return canvas::labeling::blobs(input, nbh, nlabels, functor);
+      }
+
+
+      /// The binary 2D images are labeled by runs, with the same
+      /// result.
+      template <typename L>
+      inline
+      image2d<L>
+      blobs_dispatch(const image2d<bool>& input, const neighb2d& nbh,
+		     L& nlabels)
+      {
+	if (canvas::labeling::internal::runs_connectivity(nbh) == 0)
+	{
+	  internal::dummy_functor< image2d<L> > functor;
+	  return canvas::labeling::blobs(input, nbh, nlabels, functor);
+	}
+
+	const bool val = true;
+	impl::value_functor<image2d<bool>, L> f(input, val);
+	return canvas::labeling::runs(input, nbh, nlabels, f);
+      }
+
     } // end of namespace mln::labeling::internal
 
 
@@ -109,10 +142,7 @@ namespace mln
       const N& nbh = exact(nbh_);
       mln_precondition(input.is_valid());
 
-      typedef mln_ch_value(I,L) out_t;
-      internal::dummy_functor<out_t> functor;
-      out_t
-	output = canvas::labeling::blobs(input, nbh, nlabels, functor);
+      mln_ch_value(I,L) output = internal::blobs_dispatch(input, nbh, nlabels);
 
       trace::exiting("labeling::blobs");
       return output;
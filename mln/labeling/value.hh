@@ -34,6 +34,7 @@
 # include <mln/core/concept/image.hh>
 # include <mln/core/concept/neighborhood.hh>
 # include <mln/canvas/labeling/video.hh>
+# include <mln/canvas/labeling/runs.hh>
 # include <mln/data/fill.hh>
 
 
@@ -155,7 +156,8 @@ namespace mln
 
       mln_ch_value(I, L) output;
       impl::value_functor<I,L> f(input, val);
-      output = canvas::labeling::video(input, nbh, nlabels, f);
+      output = canvas::labeling::internal::runs_dispatch(input, nbh,
+							  nlabels, f);
 
       trace::exiting("labeling::value");
       return output;
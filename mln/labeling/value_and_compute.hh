@@ -33,6 +33,8 @@
 # include <mln/core/concept/image.hh>
 # include <mln/core/concept/neighborhood.hh>
 # include <mln/canvas/labeling/video.hh>
+# include <mln/canvas/labeling/runs.hh>
+# include <mln/labeling/value.hh>
 # include <mln/data/fill.hh>
 
 
@@ -60,10 +62,110 @@ namespace mln
 		      const Neighborhood<N>& nbh, L& nlabels,
 		      const Accumulator<A>& accu);
 
+    /// \overload
+    /// The 2D images are labeled by bands of rows with c4 and c8,
+    /// and the accumulators taking sites are computed, on
+    /// \p nthreads threads if OpenMP is available. The result does
+    /// not depend on \p nthreads.
+    //
+    template <typename I, typename N, typename L, typename A>
+    util::couple<mln_ch_value(I,L),
+		 util::couple<util::array<mln_result(A)>,
+			      util::array<A> > >
+    value_and_compute(const Image<I>& input, const mln_value(I)& val,
+		      const Neighborhood<N>& nbh, L& nlabels,
+		      const Accumulator<A>& accu, unsigned nthreads);
+
+
+    /// \brief Bounding box, mass center and cardinality of the
+    /// components of a 2D image, with one contiguous array per
+    /// attribute.
+    ///
+    /// The arrays are indexed by label; index 0, the background, is
+    /// not used.
+    //
+    struct attributes2d
+    {
+      /// Resize the arrays to \p n labels, with empty attributes.
+      void resize(unsigned n);
+
+      /// Give the bounding box of the component \p l.
+      box2d bbox(unsigned l) const;
+
+      /// Give the mass center of the component \p l, as
+      /// accu::center does.
+      point2d::vec mass_center(unsigned l) const;
+
+      std::vector<def::coord> min_row, min_col, max_row, max_col;
+
+      /// Sums of the coordinates, taken site by site in the forward
+      /// order, as accu::center does.
+      std::vector<mln_sum(def::coord)> sum_row, sum_col;
+
+      std::vector<unsigned> card;
+    };
+
+
+    /// \overload
+    /// Compute the bounding boxes, mass centers and cardinalities of
+    /// the components into \p attributes, without any accumulator
+    /// object. With c4 and c8, the image is labeled by runs on
+    /// \p nthreads threads if OpenMP is available and the
+    /// attributes are updated once per run, except the sums of the
+    /// mass centers. The result does not depend on \p nthreads and
+    /// is the same as with accu::pair< accu::shape::bbox,
+    /// accu::center >.
+    //
+    template <typename V, typename L>
+    image2d<L>
+    value_and_compute(const image2d<V>& input, const V& val,
+		      const neighb2d& nbh, L& nlabels,
+		      attributes2d& attributes, unsigned nthreads);
+
 
 # ifndef MLN_INCLUDE_ONLY
 
 
+    // attributes2d
+
+    inline
+    void
+    attributes2d::resize(unsigned n)
+    {
+      min_row.assign(n, mln_max(def::coord));
+      min_col.assign(n, mln_max(def::coord));
+      max_row.assign(n, mln_min(def::coord));
+      max_col.assign(n, mln_min(def::coord));
+      sum_row.assign(n, literal::zero);
+      sum_col.assign(n, literal::zero);
+      card.assign(n, 0);
+    }
+
+    inline
+    box2d
+    attributes2d::bbox(unsigned l) const
+    {
+      mln_precondition(l < card.size());
+      if (card[l] == 0)
+	return box2d();
+      return box2d(point2d(min_row[l], min_col[l]),
+		   point2d(max_row[l], max_col[l]));
+    }
+
+    inline
+    point2d::vec
+    attributes2d::mass_center(unsigned l) const
+    {
+      mln_precondition(l < card.size());
+      if (card[l] == 0)
+	return point2d::vec();
+      algebra::vec<2, mln_sum(def::coord)> sum;
+      sum[0] = sum_row[l];
+      sum[1] = sum_col[l];
+      return sum / card[l];
+    }
+
+
     // Tests.
 
     namespace internal
@@ -198,9 +300,249 @@ namespace mln
 
       };
 
+
+      /*! \brief Label by runs the sites of \p input at \p val, on
+	\p nthreads threads.
+
+	\p runs are the runs of the components, in the forward order,
+	and \p run_label their labels. If there are too many labels
+	for \p L, they stop before the first run which would need a
+	new label, and the labels assigned so far are kept, as in
+	canvas::labeling::runs().
+       */
+      template <typename V, typename L>
+      image2d<L>
+      value_runs(const image2d<V>& input, const V& val,
+		 unsigned connectivity, L& nlabels, unsigned nthreads,
+		 std::vector<canvas::labeling::internal::run>& runs,
+		 std::vector<L>& run_label)
+      {
+	value_functor<image2d<V>, L> f(input, val);
+
+	std::vector<unsigned> parent;
+	canvas::labeling::internal::extract_runs(input, f, connectivity,
+						 nthreads, runs, parent);
+
+	image2d<L> output;
+	initialize(output, input);
+	mln::data::fill(output, L(literal::zero));
+	nlabels = 0;
+
+	// Labels, in the order of the first runs.
+	const int nruns = runs.size();
+	run_label.resize(nruns);
+	for (int i = 0; i < nruns; ++i)
+	  if (parent[i] == unsigned(i))
+	  {
+	    if (nlabels == mln_max(L))
+	    {
+	      trace::warning("labeling aborted! Too many labels for \
+				this label type: nlabels > \
+				max(label_type).");
+	      runs.resize(i);
+	      run_label.resize(i);
+	      break;
+	    }
+	    run_label[i] = ++nlabels;
+	  }
+	  else
+	    run_label[i] =
+	      run_label[canvas::labeling::internal::find_root_runs(parent, i)];
+
+	const int nlabeled = runs.size();
+#  ifdef _OPENMP
+#   pragma omp parallel for num_threads(nthreads) schedule(static)
+#  endif // ! _OPENMP
+	for (int i = 0; i < nlabeled; ++i)
+	{
+	  L* out = &output.at_(runs[i].row, runs[i].begin);
+	  std::fill(out, out + runs[i].end - runs[i].begin, run_label[i]);
+	}
+
+	return output;
+      }
+
+
+      /*! \brief Label by runs and compute the accumulators on
+	\p nthreads threads.
+
+	Each thread computes the accumulators of a subset of the
+	labels, so that every accumulator takes its sites in the
+	forward order, as in the serial version. The sums of
+	accu::center are therefore the same.
+       */
+      template <typename V, typename L, typename A>
+      util::couple<image2d<L>,
+		   util::couple<util::array<mln_result(A)>,
+				util::array<A> > >
+      value_and_compute_runs(const image2d<V>& input, const V& val,
+			     unsigned connectivity, L& nlabels,
+			     unsigned nthreads)
+      {
+	std::vector<canvas::labeling::internal::run> runs;
+	std::vector<L> run_label;
+	image2d<L> output = value_runs(input, val, connectivity, nlabels,
+				       nthreads, runs, run_label);
+
+	const int nruns = runs.size();
+	util::array<A> accus(unsigned(nlabels) + 1);
+	const int nslices = std::max(nthreads, 1u);
+
+#  ifdef _OPENMP
+#   pragma omp parallel for num_threads(nthreads) schedule(static)
+#  endif // ! _OPENMP
+	for (int slice = 0; slice < nslices; ++slice)
+	  for (int i = 0; i < nruns; ++i)
+	  {
+	    const unsigned l = run_label[i];
+	    if (l % nslices != unsigned(slice))
+	      continue;
+
+	    const canvas::labeling::internal::run& r = runs[i];
+	    A& accu = accus[l];
+	    for (int col = r.begin; col < r.end; ++col)
+	      accu.take(point2d(r.row, col));
+	  }
+
+	util::array<mln_result(A)> result;
+	convert::from_to(accus, result);
+
+	return make::couple(output, make::couple(result, accus));
+      }
+
+
+      /*! \brief Label by runs and compute the attributes on
+	\p nthreads threads.
+
+	The labels are split among the threads as in
+	value_and_compute_runs.
+       */
+      template <typename V, typename L>
+      image2d<L>
+      value_and_compute_attributes_runs(const image2d<V>& input,
+					const V& val, unsigned connectivity,
+					L& nlabels, attributes2d& attributes,
+					unsigned nthreads)
+      {
+	typedef mln_sum(def::coord) S;
+
+	std::vector<canvas::labeling::internal::run> runs;
+	std::vector<L> run_label;
+	image2d<L> output = value_runs(input, val, connectivity, nlabels,
+				       nthreads, runs, run_label);
+
+	const int nruns = runs.size();
+	attributes.resize(unsigned(nlabels) + 1);
+	def::coord
+	  *min_row = &attributes.min_row[0],
+	  *min_col = &attributes.min_col[0],
+	  *max_row = &attributes.max_row[0],
+	  *max_col = &attributes.max_col[0];
+	S
+	  *sum_row = &attributes.sum_row[0],
+	  *sum_col = &attributes.sum_col[0];
+	unsigned* card = &attributes.card[0];
+	const int nslices = std::max(nthreads, 1u);
+
+#  ifdef _OPENMP
+#   pragma omp parallel for num_threads(nthreads) schedule(static)
+#  endif // ! _OPENMP
+	for (int slice = 0; slice < nslices; ++slice)
+	  for (int i = 0; i < nruns; ++i)
+	  {
+	    const unsigned l = run_label[i];
+	    if (l % nslices != unsigned(slice))
+	      continue;
+
+	    const canvas::labeling::internal::run& r = runs[i];
+	    min_row[l] = std::min(min_row[l], def::coord(r.row));
+	    max_row[l] = std::max(max_row[l], def::coord(r.row));
+	    min_col[l] = std::min(min_col[l], def::coord(r.begin));
+	    max_col[l] = std::max(max_col[l], def::coord(r.end - 1));
+	    card[l] += r.end - r.begin;
+
+	    // Site by site, so that the sums are rounded as with
+	    // accu::center.
+	    S sr = sum_row[l], sc = sum_col[l];
+	    for (int col = r.begin; col < r.end; ++col)
+	    {
+	      sr += S(r.row);
+	      sc += S(col);
+	    }
+	    sum_row[l] = sr;
+	    sum_col[l] = sc;
+	  }
+
+	return output;
+      }
+
     } // end of namespace mln::labeling::impl
 
 
+    namespace internal
+    {
+
+      template <typename I, typename N, typename L, typename A>
+      inline
+      util::couple<mln_ch_value(I,L),
+		   util::couple<util::array<mln_result(A)>,
+				util::array<A> > >
+      value_and_compute_dispatch(metal::false_,
+				 const Image<I>& input,
+				 const mln_value(I)& val,
+				 const Neighborhood<N>& nbh, L& nlabels,
+				 const Accumulator<A>& accu, unsigned)
+      {
+	return value_and_compute(input, val, nbh, nlabels, accu);
+      }
+
+      template <typename V, typename L, typename A>
+      inline
+      util::couple<image2d<L>,
+		   util::couple<util::array<mln_result(A)>,
+				util::array<A> > >
+      value_and_compute_dispatch(metal::true_,
+				 const Image< image2d<V> >& input,
+				 const V& val,
+				 const Neighborhood<neighb2d>& nbh,
+				 L& nlabels,
+				 const Accumulator<A>& accu,
+				 unsigned nthreads)
+      {
+	const unsigned connectivity =
+	  canvas::labeling::internal::runs_connectivity(exact(nbh));
+	if (connectivity == 0)
+	  return value_and_compute(input, val, nbh, nlabels, accu);
+
+	return impl::value_and_compute_runs<V,L,A>(exact(input), val,
+						   connectivity, nlabels,
+						   nthreads);
+      }
+
+      template <typename I, typename N, typename L, typename A>
+      inline
+      util::couple<mln_ch_value(I,L),
+		   util::couple<util::array<mln_result(A)>,
+				util::array<A> > >
+      value_and_compute_dispatch(const Image<I>& input,
+				 const mln_value(I)& val,
+				 const Neighborhood<N>& nbh, L& nlabels,
+				 const Accumulator<A>& accu,
+				 unsigned nthreads)
+      {
+	enum {
+	  test = mlc_equal(I, image2d<mln_value(I)>)::value
+	  && mlc_equal(N, neighb2d)::value
+	  && mlc_equal(mln_argument(A), point2d)::value
+	};
+	return value_and_compute_dispatch(metal::bool_<test>(),
+					  input, val, nbh, nlabels, accu,
+					  nthreads);
+      }
+
+    } // end of namespace mln::labeling::internal
+
+
 
 
     // Facade.
@@ -220,7 +562,8 @@ namespace mln
       typedef mln_ch_value(I,L) out_t;
       typedef impl::value_and_compute_functor<I, L, A> func_t;
       func_t f(input, val);
-      out_t output = canvas::labeling::video(input, nbh, nlabels, f);
+      out_t output = canvas::labeling::internal::runs_dispatch(input, nbh,
+							       nlabels, f);
 
       util::couple<out_t, typename func_t::result>
 	result = make::couple(output,
@@ -231,6 +574,77 @@ namespace mln
       return result;
     }
 
+
+    template <typename I, typename N, typename L, typename A>
+    util::couple<mln_ch_value(I,L),
+		 util::couple<util::array<mln_result(A)>,
+			      util::array<A> > >
+    value_and_compute(const Image<I>& input, const mln_value(I)& val,
+		      const Neighborhood<N>& nbh, L& nlabels,
+		      const Accumulator<A>& accu, unsigned nthreads)
+    {
+      trace::entering("labeling::value_and_compute");
+
+      internal::value_and_compute_tests(input, val, nbh, nlabels, accu);
+
+      typedef mln_ch_value(I,L) out_t;
+      typedef impl::value_and_compute_functor<I, L, A> func_t;
+      util::couple<out_t, typename func_t::result>
+	result = internal::value_and_compute_dispatch(input, val, nbh,
+						      nlabels, accu,
+						      nthreads);
+
+      trace::exiting("labeling::value_and_compute");
+      return result;
+    }
+
+
+    template <typename V, typename L>
+    image2d<L>
+    value_and_compute(const image2d<V>& input, const V& val,
+		      const neighb2d& nbh, L& nlabels,
+		      attributes2d& attributes, unsigned nthreads)
+    {
+      trace::entering("labeling::value_and_compute");
+
+      mln_precondition(input.is_valid());
+      mln_precondition(nbh.is_valid());
+
+      const unsigned connectivity =
+	canvas::labeling::internal::runs_connectivity(nbh);
+      if (connectivity != 0)
+      {
+	image2d<L> output =
+	  impl::value_and_compute_attributes_runs(input, val, connectivity,
+						  nlabels, attributes,
+						  nthreads);
+	trace::exiting("labeling::value_and_compute");
+	return output;
+      }
+
+      image2d<L> output = labeling::value(input, val, nbh, nlabels);
+
+      typedef mln_sum(def::coord) S;
+      attributes.resize(unsigned(nlabels) + 1);
+      mln_fwd_piter(box2d) p(output.domain());
+      for_all(p)
+      {
+	const unsigned l = output(p);
+	if (l == 0)
+	  continue;
+	attributes.min_row[l] = std::min(attributes.min_row[l], p.row());
+	attributes.max_row[l] = std::max(attributes.max_row[l], p.row());
+	attributes.min_col[l] = std::min(attributes.min_col[l], p.col());
+	attributes.max_col[l] = std::max(attributes.max_col[l], p.col());
+	attributes.sum_row[l] += S(p.row());
+	attributes.sum_col[l] += S(p.col());
+	++attributes.card[l];
+      }
+
+      trace::exiting("labeling::value_and_compute");
+      return output;
+    }
+
 # endif // ! MLN_INCLUDE_ONLY
 
   } // end of namespace mln::labeling
@@ -30,6 +30,7 @@
 
 
 # include <mln/core/concept/image.hh>
+# include <mln/core/image/packed_image2d.hh>
 # include <mln/data/transform.hh>
 # include <mln/data/transform_inplace.hh>
 # include <mln/fun/vv2v/macros.hh>
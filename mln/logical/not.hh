@@ -68,6 +68,83 @@ namespace mln
 
 # ifndef MLN_INCLUDE_ONLY
 
+    // Implementations.
+
+    namespace impl
+    {
+
+      /// Word-level "logical not" of a packed_image2d; \p output
+      /// can be \p input.
+      inline
+      void not_packed(const packed_image2d& input, packed_image2d& output)
+      {
+	trace::entering("logical::impl::not_packed");
+
+	mln_precondition(output.domain() == input.domain());
+
+	typedef packed_image2d::word word;
+	const unsigned nwords = input.nwords();
+	const word last = input.last_word_mask();
+	const word* in = input.buffer();
+	word* out = output.buffer();
+	if (nwords != 0)
+	  for (unsigned r = 0; r < input.nrows(); ++r)
+	  {
+	    for (unsigned i = 0; i < nwords; ++i)
+	      out[i] = ~in[i];
+	    // Keep the bits beyond the last column to 0.
+	    out[nwords - 1] &= last;
+	    in += nwords;
+	    out += nwords;
+	  }
+
+	trace::exiting("logical::impl::not_packed");
+      }
+
+    } // end of namespace mln::logical::impl
+
+
+    // Dispatch.
+
+    namespace internal
+    {
+
+      template <typename I>
+      inline
+      mln_concrete(I) not_dispatch(const Image<I>& input)
+      {
+	fun::v2b::lnot<mln_value(I)> f;
+	return data::transform(input, f);
+      }
+
+      inline
+      packed_image2d not_dispatch(const Image<packed_image2d>& input)
+      {
+	packed_image2d output;
+	initialize(output, input);
+	impl::not_packed(exact(input), output);
+	return output;
+      }
+
+      template <typename I>
+      inline
+      void not_inplace_dispatch(Image<I>& input)
+      {
+	fun::v2b::lnot<mln_value(I)> f;
+	data::transform_inplace(input, f);
+      }
+
+      inline
+      void not_inplace_dispatch(Image<packed_image2d>& input)
+      {
+	impl::not_packed(exact(input), exact(input));
+      }
+
+    } // end of namespace mln::logical::internal
+
+
+    // Facades.
+
     template <typename I>
     inline
     mln_concrete(I) not_(const Image<I>& input)
@@ -76,8 +153,7 @@ namespace mln
 
       mln_precondition(exact(input).is_valid());
 
-      fun::v2b::lnot<mln_value(I)> f;
-      mln_concrete(I) output = data::transform(input, f);
+      mln_concrete(I) output = internal::not_dispatch(input);
 
       trace::exiting("logical::not_");
       return output;
@@ -91,8 +167,7 @@ namespace mln
 
       mln_precondition(exact(input).is_valid());
 
-      fun::v2b::lnot<mln_value(I)> f;
-      data::transform_inplace(input, f);
+      internal::not_inplace_dispatch(input);
 
       trace::exiting("logical::not_inplace");
     }
@@ -70,6 +70,81 @@ namespace mln
 
 # ifndef MLN_INCLUDE_ONLY
 
+    // Implementations.
+
+    namespace impl
+    {
+
+      /// Word-level "logical or" of two packed_image2d; \p output
+      /// can be one of them.
+      inline
+      void or_packed(const packed_image2d& lhs, const packed_image2d& rhs,
+		     packed_image2d& output)
+      {
+	trace::entering("logical::impl::or_packed");
+
+	mln_precondition(rhs.domain() == lhs.domain());
+	mln_precondition(output.domain() == lhs.domain());
+
+	typedef packed_image2d::word word;
+	const unsigned n = lhs.nrows() * lhs.nwords();
+	const word* l = lhs.buffer();
+	const word* r = rhs.buffer();
+	word* out = output.buffer();
+	for (unsigned i = 0; i < n; ++i)
+	  out[i] = l[i] | r[i];
+
+	trace::exiting("logical::impl::or_packed");
+      }
+
+    } // end of namespace mln::logical::impl
+
+
+    // Dispatch.
+
+    namespace internal
+    {
+
+      template <typename L, typename R>
+      inline
+      mln_ch_fun_vv2v(lor, L, R)
+      or_dispatch(const Image<L>& lhs, const Image<R>& rhs)
+      {
+	mln_fun_vv2v(lor, L, R) f;
+	return data::transform(lhs, rhs, f);
+      }
+
+      inline
+      packed_image2d
+      or_dispatch(const Image<packed_image2d>& lhs,
+		  const Image<packed_image2d>& rhs)
+      {
+	packed_image2d output;
+	initialize(output, lhs);
+	impl::or_packed(exact(lhs), exact(rhs), output);
+	return output;
+      }
+
+      template <typename L, typename R>
+      inline
+      void or_inplace_dispatch(Image<L>& lhs, const Image<R>& rhs)
+      {
+	mln_fun_vv2v(lor, L, R) f;
+	data::transform_inplace(lhs, rhs, f);
+      }
+
+      inline
+      void or_inplace_dispatch(Image<packed_image2d>& lhs,
+			       const Image<packed_image2d>& rhs)
+      {
+	impl::or_packed(exact(lhs), exact(rhs), exact(lhs));
+      }
+
+    } // end of namespace mln::logical::internal
+
+
+    // Facades.
+
     template <typename L, typename R>
     inline
     mln_ch_fun_vv2v(lor, L, R)
@@ -79,8 +154,7 @@ namespace mln
 
       internal::tests(lhs, rhs);
 
-      mln_fun_vv2v(lor, L, R) f;
-      mln_ch_fun_vv2v(lor, L, R) output = data::transform(lhs, rhs, f);
+      mln_ch_fun_vv2v(lor, L, R) output = internal::or_dispatch(lhs, rhs);
 
       trace::exiting("logical::or_");
       return output;
@@ -97,8 +171,7 @@ namespace mln
 
       internal::tests(lhs, rhs);
 
-      mln_fun_vv2v(lor, L, R) f;
-      data::transform_inplace(lhs, rhs, f);
+      internal::or_inplace_dispatch(lhs, rhs);
 
       trace::exiting("logical::or_inplace");
     }
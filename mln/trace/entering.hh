@@ -46,28 +46,17 @@ namespace mln
 
     void entering(const std::string& scope);
 
-    extern std::stack<std::clock_t> start_times;
-    extern std::stack<std::string>  scopes;      // For testing purpose
-                                                 // (entering/exiting scope matching).
-
 
 # ifndef MLN_INCLUDE_ONLY
 
-#  ifndef MLN_WO_GLOBAL_VARS
-
-    std::stack<std::clock_t> start_times;
-    std::stack<std::string>  scopes;
-
-#  endif // !MLN_WO_GLOBAL_VARS
-
     inline
     void entering(const std::string& scope)
     {
-      if (quiet)
+      if (quiet || internal::is_stopped)
 	return;
 
-      start_times.push(std::clock());
-      scopes.push(scope);
+      internal::start_times().push(std::clock());
+      internal::scopes().push(scope);
 
       if ((tab != 0) && (internal::max_tab == tab))
 	std::cout << std::endl;
@@ -46,18 +46,17 @@ namespace mln
     void exiting(const std::string& scope);
 
 
-    extern std::stack<std::clock_t> start_times;
-    extern std::stack<std::string>  scopes;      // For testing purpose
-                                                 // (entering/exiting scope matching).
-
 # ifndef MLN_INCLUDE_ONLY
 
     inline
     void exiting(const std::string& scope)
     {
-      if (quiet)
+      if (quiet || internal::is_stopped)
 	return;
 
+      std::stack<std::clock_t>& start_times = internal::start_times();
+      std::stack<std::string>& scopes = internal::scopes();
+
       if (scopes.empty())
 	{
 	  std::cerr << "error: missing 'entering' scope (exiting is '" << scope << "')" << std::endl;
@@ -29,11 +29,27 @@
 /*! \file
  *
  * \brief Definition of the trace quiet Boolean value.
+ *
+ * trace::quiet is a process-wide switch.  The indentation, the open
+ * scopes and the trace::stop() state are local to each thread, so that
+ * routines may be run concurrently whether traces are enabled or not.
  */
 
 # include <ctime>
+# include <stack>
+# include <string>
 # include <sys/time.h>
 
+
+# if defined(__GNUC__)
+#  define MLN_TRACE_THREAD_LOCAL __thread
+# elif defined(_MSC_VER)
+#  define MLN_TRACE_THREAD_LOCAL __declspec(thread)
+# else
+#  define MLN_TRACE_THREAD_LOCAL
+# endif
+
+
 namespace mln
 {
 
@@ -41,16 +57,24 @@ namespace mln
   {
 
     extern bool quiet;
-    extern unsigned tab ;
+    extern MLN_TRACE_THREAD_LOCAL unsigned tab ;
     extern bool full_trace;
 
 
     namespace internal
     {
 
-      extern unsigned max_tab ;
+      extern MLN_TRACE_THREAD_LOCAL unsigned max_tab ;
       extern timeval start_time;
-      extern bool is_quiet;
+      extern MLN_TRACE_THREAD_LOCAL bool was_stopped;
+      extern MLN_TRACE_THREAD_LOCAL bool is_stopped;
+
+      /// Start times of the current thread's open scopes.
+      std::stack<std::clock_t>& start_times();
+
+      /// Current thread's open scopes (for entering/exiting scope
+      /// matching).
+      std::stack<std::string>& scopes();
 
     } // end of namespace mln::trace::internal
 
@@ -60,20 +84,48 @@ namespace mln
 #  ifndef MLN_WO_GLOBAL_VARS
 
     bool quiet = true;
-    unsigned tab  = 0;
+    MLN_TRACE_THREAD_LOCAL unsigned tab  = 0;
     bool full_trace = false;
 
 
     namespace internal
     {
 
-      unsigned max_tab  = 0;
+      MLN_TRACE_THREAD_LOCAL unsigned max_tab  = 0;
       timeval start_time;
-      bool is_quiet = quiet;
+      MLN_TRACE_THREAD_LOCAL bool was_stopped = false;
+      MLN_TRACE_THREAD_LOCAL bool is_stopped = false;
     } // end of namespace mln::trace::internal
 
 #  endif // !MLN_WO_GLOBAL_VARS
 
+
+    namespace internal
+    {
+
+      // The stacks are only allocated by threads with traces enabled
+      // and are never released.
+
+      inline
+      std::stack<std::clock_t>& start_times()
+      {
+	static MLN_TRACE_THREAD_LOCAL std::stack<std::clock_t>* s = 0;
+	if (s == 0)
+	  s = new std::stack<std::clock_t>();
+	return *s;
+      }
+
+      inline
+      std::stack<std::string>& scopes()
+      {
+	static MLN_TRACE_THREAD_LOCAL std::stack<std::string>* s = 0;
+	if (s == 0)
+	  s = new std::stack<std::string>();
+	return *s;
+      }
+
+    } // end of namespace mln::trace::internal
+
 # endif // !MLN_INCLUDE_ONLY
 
   } // end of namespace mln::trace
@@ -47,7 +47,7 @@ namespace mln
     inline
     void resume()
     {
-       quiet = internal::is_quiet;
+       internal::is_stopped = internal::was_stopped;
     }
 
 # endif // ! MLN_INCLUDE_ONLY
@@ -48,9 +48,9 @@ namespace mln
     inline
     void stop()
     {
-      internal::is_quiet = quiet;
+      internal::was_stopped = internal::is_stopped;
       if (!full_trace)
-	quiet = true;
+	internal::is_stopped = true;
     }
 
 # endif // ! MLN_INCLUDE_ONLY
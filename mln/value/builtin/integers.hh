@@ -52,6 +52,8 @@ namespace mln
   template <> struct category<   signed int   > { typedef value::Built_In< value::Integer<void> > ret; };
   template <> struct category< unsigned long  > { typedef value::Built_In< value::Integer<void> > ret; };
   template <> struct category<   signed long  > { typedef value::Built_In< value::Integer<void> > ret; };
+  template <> struct category< unsigned long long > { typedef value::Built_In< value::Integer<void> > ret; };
+  template <> struct category<   signed long long > { typedef value::Built_In< value::Integer<void> > ret; };
 
 
   namespace trait
@@ -151,6 +153,20 @@ namespace mln
       { return "signed long"; }
     };
 
+    template <> struct value_< unsigned long long >
+      : internal::value_integer_< unsigned long long >
+    {
+      static const char* name()
+      { return "unsigned long long"; }
+    };
+
+    template <> struct value_<   signed long long >
+      : internal::value_integer_<   signed long long >
+    {
+      static const char* name()
+      { return "signed long long"; }
+    };
+
   } // end of namespace mln::trait
 
 } // end of namespace mln
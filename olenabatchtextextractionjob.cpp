@@ -0,0 +1,231 @@
+/*
+ * This file is part of the Nepomuk KDE project.
+ * Copyright (c) 2009-2010 Sebastian Trueg <trueg@kde.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "olenabatchtextextractionjob.h"
+#include "olenatextextractiontask_p.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QThreadPool>
+
+#include <KIO/Job>
+#include <KDebug>
+
+
+class Nepomuk::OlenaBatchTextExtractionJob::Private
+{
+public:
+    KUrl::List m_urls;
+    int m_nextUrl;
+    int m_queued;
+    int m_maxQueueDepth;
+    int m_timeBudget;
+    bool m_textPrecheck;
+
+    // the downloads of the remote urls, they count as queued
+    QHash<KJob*, KUrl> m_transferJobs;
+
+    OlenaTaskLinkPtr m_link;
+};
+
+
+Nepomuk::OlenaBatchTextExtractionJob::OlenaBatchTextExtractionJob( QObject* parent )
+    : KJob( parent ),
+      d( new Private() )
+{
+    d->m_nextUrl = 0;
+    d->m_queued = 0;
+    d->m_maxQueueDepth = 0;
+    d->m_timeBudget = 0;
+    d->m_textPrecheck = true;
+    d->m_link = OlenaTaskLinkPtr( new OlenaTaskLink( this ) );
+}
+
+
+Nepomuk::OlenaBatchTextExtractionJob::~OlenaBatchTextExtractionJob()
+{
+    // the tasks stop at their next checkpoint, their results are dropped
+    d->m_link->detach();
+    d->m_link->cancel();
+    killTransferJobs();
+    delete d;
+}
+
+
+void Nepomuk::OlenaBatchTextExtractionJob::setUrls( const KUrl::List& urls )
+{
+    d->m_urls = urls;
+}
+
+
+KUrl::List Nepomuk::OlenaBatchTextExtractionJob::urls() const
+{
+    return d->m_urls;
+}
+
+
+void Nepomuk::OlenaBatchTextExtractionJob::setMaximumQueueDepth( int depth )
+{
+    d->m_maxQueueDepth = depth;
+}
+
+
+int Nepomuk::OlenaBatchTextExtractionJob::maximumQueueDepth() const
+{
+    if ( d->m_maxQueueDepth > 0 )
+        return d->m_maxQueueDepth;
+    else
+        return 2 * olenaThreadPool()->maxThreadCount();
+}
+
+
+void Nepomuk::OlenaBatchTextExtractionJob::setTimeBudget( int msecs )
+{
+    d->m_timeBudget = msecs;
+}
+
+
+int Nepomuk::OlenaBatchTextExtractionJob::timeBudget() const
+{
+    return d->m_timeBudget;
+}
+
+
+void Nepomuk::OlenaBatchTextExtractionJob::setTextPrecheckEnabled( bool enabled )
+{
+    d->m_textPrecheck = enabled;
+}
+
+
+bool Nepomuk::OlenaBatchTextExtractionJob::textPrecheckEnabled() const
+{
+    return d->m_textPrecheck;
+}
+
+
+Nepomuk::OlenaBatchTextExtractionJob* Nepomuk::OlenaBatchTextExtractionJob::extractTexts( const KUrl::List& urls )
+{
+    OlenaBatchTextExtractionJob* job = new OlenaBatchTextExtractionJob();
+    job->setUrls( urls );
+    return job;
+}
+
+
+void Nepomuk::OlenaBatchTextExtractionJob::start()
+{
+    kDebug() << d->m_urls.count();
+    setTotalAmount( KJob::Files, d->m_urls.count() );
+    queueUrls();
+    if ( d->m_queued == 0 )
+        emitResult();
+}
+
+
+void Nepomuk::OlenaBatchTextExtractionJob::cancel()
+{
+    kDebug();
+    d->m_link->cancel();
+}
+
+
+bool Nepomuk::OlenaBatchTextExtractionJob::doKill()
+{
+    killTransferJobs();
+    // KJob::kill() emits the result itself
+    d->m_link->detach();
+    d->m_link->cancel();
+    return true;
+}
+
+
+void Nepomuk::OlenaBatchTextExtractionJob::killTransferJobs()
+{
+    Q_FOREACH( KJob* job, d->m_transferJobs.keys() )
+        job->kill();
+    d->m_queued -= d->m_transferJobs.count();
+    d->m_transferJobs.clear();
+}
+
+
+void Nepomuk::OlenaBatchTextExtractionJob::queueUrls()
+{
+    if ( d->m_link->cancellation().is_canceled() )
+        return;
+
+    while ( d->m_queued < maximumQueueDepth() && d->m_nextUrl < d->m_urls.count() ) {
+        const KUrl url = d->m_urls[d->m_nextUrl++];
+        if ( url.isLocalFile() ) {
+            queueTask( new OlenaTextExtractionTask( d->m_link, url, url.toLocalFile() ) );
+        }
+        else {
+            // download into memory, the task is queued once done
+            KJob* job = KIO::storedGet( url, KIO::NoReload, KIO::HideProgressInfo );
+            connect( job, SIGNAL( result( KJob* ) ),
+                     this, SLOT( slotTransferResult( KJob* ) ) );
+            d->m_transferJobs.insert( job, url );
+        }
+        ++d->m_queued;
+    }
+}
+
+
+void Nepomuk::OlenaBatchTextExtractionJob::queueTask( OlenaTextExtractionTask* task )
+{
+    task->setTimeBudget( d->m_timeBudget );
+    task->setTextPrecheck( d->m_textPrecheck );
+    olenaThreadPool()->start( task );
+}
+
+
+void Nepomuk::OlenaBatchTextExtractionJob::slotTransferResult( KJob* job )
+{
+    const KUrl url = d->m_transferJobs.take( job );
+    if ( !job->error() ) {
+        KIO::StoredTransferJob* transferJob = static_cast<KIO::StoredTransferJob*>( job );
+        queueTask( new OlenaTextExtractionTask( d->m_link, url, transferJob->data() ) );
+    }
+    else {
+        kDebug() << "Failed to download" << url << job->errorString();
+        slotTextExtracted( url, QString() );
+    }
+}
+
+
+void Nepomuk::OlenaBatchTextExtractionJob::slotLineRecognized( const KUrl& url, const QString& text, const QRect& rect )
+{
+    if ( d->m_link->isDetached() )
+        return;
+    emit lineRecognized( url, text, rect );
+}
+
+
+void Nepomuk::OlenaBatchTextExtractionJob::slotTextExtracted( const KUrl& url, const QString& text )
+{
+    if ( d->m_link->isDetached() )
+        return;
+    --d->m_queued;
+    emit textExtracted( url, text );
+    setProcessedAmount( KJob::Files, processedAmount( KJob::Files ) + 1 );
+
+    queueUrls();
+    if ( d->m_queued == 0 )
+        emitResult();
+}
+
+#include "olenabatchtextextractionjob.moc"
@@ -0,0 +1,121 @@
+/*
+ * This file is part of the Nepomuk KDE project.
+ * Copyright (c) 2009-2010 Sebastian Trueg <trueg@kde.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _OLENA_BATCH_TEXT_EXTRACTION_JOB_H_
+#define _OLENA_BATCH_TEXT_EXTRACTION_JOB_H_
+
+#include <KJob>
+#include <KUrl>
+
+#include <QtCore/QRect>
+
+#include "kolena_export.h"
+
+namespace Nepomuk {
+    class OlenaTextExtractionTask;
+
+    /**
+     * Extracts the text from a list of images.
+     *
+     * The images are processed in the thread pool shared by all the
+     * extraction jobs (see OlenaTextExtractionJob::setMaximumConcurrency())
+     * and textExtracted() is emitted for each of them as soon as it is done.
+     * At most maximumQueueDepth() images are downloaded or queued in the pool
+     * at a time. Local files are read in place, remote urls are downloaded
+     * into memory.
+     */
+    class KOLENA_EXPORT OlenaBatchTextExtractionJob : public KJob
+    {
+        Q_OBJECT
+
+    public:
+        OlenaBatchTextExtractionJob( QObject* parent = 0 );
+        ~OlenaBatchTextExtractionJob();
+
+        void setUrls( const KUrl::List& urls );
+        KUrl::List urls() const;
+
+        /**
+         * Set the maximum number of images queued or processed at the same
+         * time for this job. Defaults to twice the maximum concurrency.
+         */
+        void setMaximumQueueDepth( int depth );
+        int maximumQueueDepth() const;
+
+        /**
+         * Stop processing an image after \p msecs milliseconds and report the
+         * text recognized so far, if any. 0, the default, means no limit.
+         */
+        void setTimeBudget( int msecs );
+        int timeBudget() const;
+
+        /**
+         * Run a cheap check on a subsampled image first and skip the images
+         * which do not seem to contain any text, such as photos. Small text
+         * may be missed. Enabled by default.
+         */
+        void setTextPrecheckEnabled( bool enabled );
+        bool textPrecheckEnabled() const;
+
+        static OlenaBatchTextExtractionJob* extractTexts( const KUrl::List& urls );
+
+    Q_SIGNALS:
+        /**
+         * Emitted once per url. \p text is empty if the url could not be
+         * read or if no text was found.
+         */
+        void textExtracted( const KUrl& url, const QString& text );
+
+        /**
+         * Emitted for each line of text of \p url as soon as it has been
+         * recognized, before textExtracted(). See
+         * OlenaTextExtractionJob::lineRecognized().
+         */
+        void lineRecognized( const KUrl& url, const QString& text, const QRect& rect );
+
+    public Q_SLOTS:
+        void start();
+
+        /**
+         * Stop processing as soon as possible. The queued images are reported
+         * with the text recognized so far, if any, and the remaining ones are
+         * skipped.
+         */
+        void cancel();
+
+    protected:
+        bool doKill();
+
+    private Q_SLOTS:
+        void slotTransferResult( KJob* job );
+        void slotLineRecognized( const KUrl& url, const QString& text, const QRect& rect );
+        void slotTextExtracted( const KUrl& url, const QString& text );
+
+    private:
+        void queueUrls();
+        void queueTask( OlenaTextExtractionTask* task );
+        void killTransferJobs();
+
+        class Private;
+        Private* const d;
+    };
+}
+
+#endif
@@ -0,0 +1,216 @@
+/*
+ * This file is part of the Nepomuk KDE project.
+ * Copyright (c) 2009-2010 Sebastian Trueg <trueg@kde.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "olenaresultcache_p.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QStringList>
+
+#include <QtGui/QImage>
+
+#include <KGlobal>
+#include <KSaveFile>
+#include <KDebug>
+
+namespace {
+    const quint32 s_magic = 0x4f6c5263; // "OlRc"
+    const quint32 s_version = 1;
+}
+
+K_GLOBAL_STATIC( Nepomuk::OlenaResultCache, s_olenaResultCache )
+
+
+Nepomuk::OlenaResultCache::OlenaResultCache()
+    : m_maximumSize( 8*1024*1024 ),
+      m_size( -1 )
+{
+}
+
+
+Nepomuk::OlenaResultCache* Nepomuk::OlenaResultCache::global()
+{
+    return s_olenaResultCache;
+}
+
+
+void Nepomuk::OlenaResultCache::setDirectory( const QString& directory )
+{
+    QMutexLocker lock( &m_mutex );
+    m_directory = directory;
+    m_size = -1;
+    if ( !m_directory.isEmpty() )
+        QDir().mkpath( m_directory );
+}
+
+
+QString Nepomuk::OlenaResultCache::directory() const
+{
+    QMutexLocker lock( &m_mutex );
+    return m_directory;
+}
+
+
+bool Nepomuk::OlenaResultCache::isEnabled() const
+{
+    QMutexLocker lock( &m_mutex );
+    return !m_directory.isEmpty();
+}
+
+
+void Nepomuk::OlenaResultCache::setMaximumSize( qint64 bytes )
+{
+    QMutexLocker lock( &m_mutex );
+    m_maximumSize = bytes;
+    m_size = -1;
+}
+
+
+qint64 Nepomuk::OlenaResultCache::maximumSize() const
+{
+    QMutexLocker lock( &m_mutex );
+    return m_maximumSize;
+}
+
+
+QByteArray Nepomuk::OlenaResultCache::key( const QImage& image, const QByteArray& params )
+{
+    QCryptographicHash hash( QCryptographicHash::Md5 );
+    hash.addData( params );
+    hash.addData( QByteArray::number( image.width() ) + 'x' + QByteArray::number( image.height() )
+                  + '@' + QByteArray::number( int( image.format() ) ) );
+
+    // indexed images with the same indices may use different palettes
+    const QVector<QRgb> colors = image.colorTable();
+    if ( !colors.isEmpty() )
+        hash.addData( reinterpret_cast<const char*>( colors.constData() ),
+                      colors.size() * sizeof( QRgb ) );
+
+    // skip the scanline padding, its content is undefined
+    const int rowLength = ( image.width() * image.depth() + 7 ) / 8;
+    for ( int row = 0; row < image.height(); ++row )
+        hash.addData( reinterpret_cast<const char*>( image.constScanLine( row ) ), rowLength );
+
+    return hash.result().toHex();
+}
+
+
+bool Nepomuk::OlenaResultCache::lookup( const QByteArray& key, Entry* entry ) const
+{
+    const QString filePath = path( key );
+    if ( filePath.isEmpty() )
+        return false;
+
+    QFile file( filePath );
+    if ( !file.open( QIODevice::ReadOnly ) )
+        return false;
+
+    QDataStream header( &file );
+    quint32 magic = 0, version = 0;
+    header >> magic >> version;
+    if ( magic != s_magic || version != s_version )
+        return false;
+
+    const QByteArray data = qUncompress( file.readAll() );
+    QDataStream stream( data );
+    stream.setVersion( QDataStream::Qt_4_6 );
+
+    Entry result;
+    stream >> result.text >> result.lines;
+    if ( stream.status() != QDataStream::Ok ) {
+        kDebug() << "Corrupted cache entry" << filePath;
+        return false;
+    }
+
+    *entry = result;
+    return true;
+}
+
+
+void Nepomuk::OlenaResultCache::insert( const QByteArray& key, const Entry& entry )
+{
+    const QString filePath = path( key );
+    if ( filePath.isEmpty() )
+        return;
+
+    QByteArray data;
+    QDataStream stream( &data, QIODevice::WriteOnly );
+    stream.setVersion( QDataStream::Qt_4_6 );
+    stream << entry.text << entry.lines;
+
+    KSaveFile file( filePath );
+    if ( !file.open() ) {
+        kDebug() << "Failed to create" << filePath << file.errorString();
+        return;
+    }
+
+    QDataStream header( &file );
+    header << s_magic << s_version;
+    file.write( qCompress( data ) );
+    const qint64 size = file.size();
+    if ( !file.finalize() ) {
+        kDebug() << "Failed to write" << filePath << file.errorString();
+        return;
+    }
+
+    QMutexLocker lock( &m_mutex );
+    if ( m_size >= 0 )
+        m_size += size;
+    if ( m_size < 0 || m_size > m_maximumSize )
+        prune();
+}
+
+
+void Nepomuk::OlenaResultCache::prune()
+{
+    if ( m_directory.isEmpty() )
+        return;
+
+    // oldest first; other processes may have added entries meanwhile
+    const QStringList keys( QString( 32, QLatin1Char( '?' ) ) );
+    const QFileInfoList entries = QDir( m_directory ).entryInfoList( keys, QDir::Files,
+                                                                     QDir::Time | QDir::Reversed );
+    m_size = 0;
+    Q_FOREACH( const QFileInfo& entry, entries )
+        m_size += entry.size();
+
+    if ( m_size <= m_maximumSize )
+        return;
+
+    const qint64 target = m_maximumSize / 4 * 3;
+    for ( int i = 0; i < entries.count() && m_size > target; ++i ) {
+        if ( QFile::remove( entries[i].filePath() ) )
+            m_size -= entries[i].size();
+    }
+    kDebug() << "Pruned the result cache to" << m_size << "bytes";
+}
+
+
+QString Nepomuk::OlenaResultCache::path( const QByteArray& key ) const
+{
+    QMutexLocker lock( &m_mutex );
+    if ( m_directory.isEmpty() )
+        return QString();
+    return m_directory + QLatin1Char( '/' ) + QString::fromLatin1( key );
+}
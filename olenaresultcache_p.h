@@ -0,0 +1,92 @@
+/*
+ * This file is part of the Nepomuk KDE project.
+ * Copyright (c) 2009-2010 Sebastian Trueg <trueg@kde.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _OLENA_RESULT_CACHE_P_H_
+#define _OLENA_RESULT_CACHE_P_H_
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
+#include <QtCore/QRect>
+#include <QtCore/QString>
+
+class QImage;
+
+namespace Nepomuk {
+    /**
+     * On-disk store of extraction results, addressed by the decoded pixels
+     * and the pipeline parameters rather than by url, so that renamed,
+     * touched or re-tagged images are not processed again.
+     *
+     * Each entry is a small compressed file named after its key. Entries are
+     * written atomically, so the cache can be used by several threads and
+     * processes at the same time. Once the entries exceed maximumSize(), the
+     * oldest ones are removed.
+     */
+    class OlenaResultCache
+    {
+    public:
+        struct Entry {
+            QString text;
+            /// The recognized lines and their bounding box.
+            QList<QPair<QString, QRect> > lines;
+        };
+
+        OlenaResultCache();
+
+        /// The cache shared by all the extraction tasks.
+        static OlenaResultCache* global();
+
+        /// Store the entries in \p directory. An empty path disables the cache.
+        void setDirectory( const QString& directory );
+        QString directory() const;
+
+        bool isEnabled() const;
+
+        /// The size in bytes the entries may take on disk, 8 MiB by default.
+        void setMaximumSize( qint64 bytes );
+        qint64 maximumSize() const;
+
+        /**
+         * Hash the pixels and the color table of \p image together with
+         * \p params, a serialization of the parameters the result depends on.
+         */
+        static QByteArray key( const QImage& image, const QByteArray& params );
+
+        bool lookup( const QByteArray& key, Entry* entry ) const;
+        void insert( const QByteArray& key, const Entry& entry );
+
+    private:
+        QString path( const QByteArray& key ) const;
+
+        /// Remove the oldest entries until they take at most 3/4 of the
+        /// maximum size. Called with m_mutex locked.
+        void prune();
+
+        mutable QMutex m_mutex;
+        QString m_directory;
+        qint64 m_maximumSize;
+        /// Estimated size of the entries, -1 if unknown.
+        qint64 m_size;
+    };
+}
+
+#endif
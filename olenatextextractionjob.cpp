@@ -19,85 +19,51 @@
  */
 
 #include "olenatextextractionjob.h"
+#include "olenatextextractiontask_p.h"
+#include "olenaresultcache_p.h"
 
 #include <QtCore/QThread>
-#include <QtCore/QMutex>
-#include <QtCore/QMutexLocker>
-#include <QtCore/QFile>
+#include <QtCore/QThreadPool>
 
-#include <KIO/NetAccess>
+#include <KIO/Job>
+#include <KStandardDirs>
 #include <KDebug>
 
-#include <string>
 
-#include <mln/io/ppm/load.hh>
-#include <mln/io/ppm/save.hh>
-#include <mln/labeling/colorize.hh>
-
-#include "text_extraction.hh"
-
-namespace {
-/**
- * We check two basic things:
- * 1. is there any text at all
- * 2. Is the letter/non-letter ratio useful - this is a primitive attempt to exclude garbage such as " W Y œe "ii" ï§ _* ,"
- */
-bool checkText( const QString& text ) {
-    if(!text.isEmpty()) {
-        int letterCnt = 0;
-        int spaceCnt = 0;
-        Q_FOREACH(const QChar& c, text) {
-            if(c.isLetterOrNumber())
-                ++letterCnt;
-            else if(c.isSpace())
-                ++spaceCnt;
-        }
-        double letterRatio = double(letterCnt)/double(text.length());
-        double spaceRatio = double(spaceCnt)/double(text.length());
-        kDebug() << "Letter ration of" << text << letterRatio << spaceRatio;
-        return letterRatio > 0.7 && spaceRatio < 0.3;
-    }
-    else {
-        return false;
-    }
-}
-}
-
-class Nepomuk::OlenaTextExtractionJob::Private : public QThread
+class Nepomuk::OlenaTextExtractionJob::Private
 {
 public:
     KUrl m_url;
-    QString m_tmpFilePath;
+
+    // the download of a remote url, 0 once done
+    KIO::StoredTransferJob* m_transferJob;
 
     QString m_extractedText;
+    int m_timeBudget;
+    bool m_textPrecheck;
 
-private:
-    void run();
+    OlenaTaskLinkPtr m_link;
 };
 
 
-void Nepomuk::OlenaTextExtractionJob::Private::run()
-{
-    m_extractedText = scribo::toolchain::nepomuk::text_extraction( QImage( m_tmpFilePath ) );
-    kDebug() << m_extractedText;
-    if(!checkText(m_extractedText)) {
-        kDebug() << "Extracted text seems to be junk.";
-        m_extractedText.truncate(0);
-    }
-}
-
-
 Nepomuk::OlenaTextExtractionJob::OlenaTextExtractionJob( QObject* parent )
     : KJob( parent ),
       d( new Private() )
 {
-    connect( d, SIGNAL( finished() ), this, SLOT( slotFinished() ) );
+    d->m_transferJob = 0;
+    d->m_timeBudget = 0;
+    d->m_textPrecheck = true;
+    d->m_link = OlenaTaskLinkPtr( new OlenaTaskLink( this ) );
 }
 
 
 Nepomuk::OlenaTextExtractionJob::~OlenaTextExtractionJob()
 {
-    d->wait();
+    // the task stops at its next checkpoint, its results are dropped
+    d->m_link->detach();
+    d->m_link->cancel();
+    if ( d->m_transferJob )
+        d->m_transferJob->kill();
     delete d;
 }
 
@@ -110,22 +76,114 @@ Nepomuk::OlenaTextExtractionJob* Nepomuk::OlenaTextExtractionJob::extractText( c
 }
 
 
+void Nepomuk::OlenaTextExtractionJob::setMaximumConcurrency( int threads )
+{
+    olenaThreadPool()->setMaxThreadCount( threads );
+}
+
+
+int Nepomuk::OlenaTextExtractionJob::maximumConcurrency()
+{
+    return olenaThreadPool()->maxThreadCount();
+}
+
+
+void Nepomuk::OlenaTextExtractionJob::setTimeBudget( int msecs )
+{
+    d->m_timeBudget = msecs;
+}
+
+
+int Nepomuk::OlenaTextExtractionJob::timeBudget() const
+{
+    return d->m_timeBudget;
+}
+
+
+void Nepomuk::OlenaTextExtractionJob::setTextPrecheckEnabled( bool enabled )
+{
+    d->m_textPrecheck = enabled;
+}
+
+
+bool Nepomuk::OlenaTextExtractionJob::textPrecheckEnabled() const
+{
+    return d->m_textPrecheck;
+}
+
+
+void Nepomuk::OlenaTextExtractionJob::setResultCacheEnabled( bool enabled, const QString& directory )
+{
+    if ( !enabled )
+        OlenaResultCache::global()->setDirectory( QString() );
+    else if ( directory.isEmpty() )
+        OlenaResultCache::global()->setDirectory( KStandardDirs::locateLocal( "cache", QLatin1String( "kolena/" ) ) );
+    else
+        OlenaResultCache::global()->setDirectory( directory );
+}
+
+
+bool Nepomuk::OlenaTextExtractionJob::resultCacheEnabled()
+{
+    return OlenaResultCache::global()->isEnabled();
+}
+
+
+void Nepomuk::OlenaTextExtractionJob::setResultCacheMaximumSize( qint64 bytes )
+{
+    OlenaResultCache::global()->setMaximumSize( bytes );
+}
+
+
+qint64 Nepomuk::OlenaTextExtractionJob::resultCacheMaximumSize()
+{
+    return OlenaResultCache::global()->maximumSize();
+}
+
+
 void Nepomuk::OlenaTextExtractionJob::start()
 {
     kDebug();
-    if ( KIO::NetAccess::download( d->m_url, d->m_tmpFilePath, 0 ) ) {
-        kDebug() << "Starting thread";
-        d->start();
+    if ( d->m_url.isLocalFile() ) {
+        queueTask( new OlenaTextExtractionTask( d->m_link, d->m_url, d->m_url.toLocalFile() ) );
     }
     else {
-        kDebug() << "Failed to download" << d->m_url << KIO::NetAccess::lastErrorString();
-        emitResult();
+        // download into memory, the image is decoded from there
+        d->m_transferJob = KIO::storedGet( d->m_url, KIO::NoReload, KIO::HideProgressInfo );
+        connect( d->m_transferJob, SIGNAL( result( KJob* ) ),
+                 this, SLOT( slotTransferResult( KJob* ) ) );
     }
 }
 
 
+void Nepomuk::OlenaTextExtractionJob::queueTask( OlenaTextExtractionTask* task )
+{
+    kDebug() << "Queuing extraction";
+    task->setConcurrentPasses( true );
+    task->setTimeBudget( d->m_timeBudget );
+    task->setTextPrecheck( d->m_textPrecheck );
+    task->setBinarizationThreads( QThread::idealThreadCount() );
+    olenaThreadPool()->start( task );
+}
+
+
 void Nepomuk::OlenaTextExtractionJob::cancel()
 {
+    kDebug() << d->m_url;
+    d->m_link->cancel();
+}
+
+
+bool Nepomuk::OlenaTextExtractionJob::doKill()
+{
+    if ( d->m_transferJob ) {
+        d->m_transferJob->kill();
+        d->m_transferJob = 0;
+    }
+    // KJob::kill() emits the result itself
+    d->m_link->detach();
+    d->m_link->cancel();
+    return true;
 }
 
 
@@ -135,9 +193,33 @@ QString Nepomuk::OlenaTextExtractionJob::text() const
 }
 
 
-void Nepomuk::OlenaTextExtractionJob::slotFinished()
+void Nepomuk::OlenaTextExtractionJob::slotTransferResult( KJob* job )
+{
+    d->m_transferJob = 0;
+    if ( job->error() ) {
+        kDebug() << "Failed to download" << d->m_url << job->errorString();
+        emitResult();
+    }
+    else {
+        KIO::StoredTransferJob* transferJob = static_cast<KIO::StoredTransferJob*>( job );
+        queueTask( new OlenaTextExtractionTask( d->m_link, d->m_url, transferJob->data() ) );
+    }
+}
+
+
+void Nepomuk::OlenaTextExtractionJob::slotLineRecognized( const KUrl&, const QString& text, const QRect& rect )
+{
+    if ( d->m_link->isDetached() )
+        return;
+    emit lineRecognized( text, rect );
+}
+
+
+void Nepomuk::OlenaTextExtractionJob::slotTextExtracted( const KUrl&, const QString& text )
 {
-    KIO::NetAccess::removeTempFile( d->m_tmpFilePath );
+    if ( d->m_link->isDetached() )
+        return;
+    d->m_extractedText = text;
     emitResult();
 }
 
@@ -24,9 +24,17 @@
 #include <KJob>
 #include <KUrl>
 
+#include <QtCore/QRect>
+
 #include "kolena_export.h"
 
 namespace Nepomuk {
+    class OlenaTextExtractionTask;
+
+    /**
+     * Extracts the text from one image. Local files are read in place,
+     * remote urls are downloaded into memory.
+     */
     class KOLENA_EXPORT OlenaTextExtractionJob : public KJob
     {
         Q_OBJECT
@@ -39,14 +47,76 @@ namespace Nepomuk {
 
         static OlenaTextExtractionJob* extractText( const KUrl& url );
 
+        /**
+         * Set the maximum number of images processed at the same time by all
+         * the extraction jobs, including batch jobs. Defaults to the number of
+         * CPU cores.
+         */
+        static void setMaximumConcurrency( int threads );
+        static int maximumConcurrency();
+
+        /**
+         * Stop processing the image after \p msecs milliseconds and report
+         * the text recognized so far, if any. 0, the default, means no limit.
+         */
+        void setTimeBudget( int msecs );
+        int timeBudget() const;
+
+        /**
+         * Run a cheap check on a subsampled image first and skip the images
+         * which do not seem to contain any text, such as photos. Small text
+         * may be missed. Enabled by default.
+         */
+        void setTextPrecheckEnabled( bool enabled );
+        bool textPrecheckEnabled() const;
+
+        /**
+         * Enable or disable the result cache shared by all the extraction
+         * jobs, including batch jobs. Results are keyed by the decoded pixels
+         * and the pipeline parameters, so an image is not processed again
+         * after it has been renamed, touched or had its metadata edited.
+         * \p directory defaults to a "kolena" folder in the user cache
+         * directory. Disabled by default.
+         */
+        static void setResultCacheEnabled( bool enabled, const QString& directory = QString() );
+        static bool resultCacheEnabled();
+
+        /**
+         * The size in bytes the result cache may take on disk. The oldest
+         * results are removed beyond it. Defaults to 8 MiB.
+         */
+        static void setResultCacheMaximumSize( qint64 bytes );
+        static qint64 resultCacheMaximumSize();
+
     public Q_SLOTS:
         void start();
+
+        /**
+         * Stop processing as soon as possible. The job still emits its result,
+         * with the text recognized so far, if any.
+         */
         void cancel();
 
+    Q_SIGNALS:
+        /**
+         * Emitted for each line of text as soon as it has been recognized,
+         * before the job emits its result. \p rect is the line bounding box in
+         * the deskewed image. The lines are not filtered: text() may still
+         * drop them if the whole result looks like junk.
+         */
+        void lineRecognized( const QString& text, const QRect& rect );
+
+    protected:
+        bool doKill();
+
     private Q_SLOTS:
-        void slotFinished();
+        void slotTransferResult( KJob* job );
+        void slotLineRecognized( const KUrl& url, const QString& text, const QRect& rect );
+        void slotTextExtracted( const KUrl& url, const QString& text );
 
     private:
+        void queueTask( OlenaTextExtractionTask* task );
+
         class Private;
         Private* const d;
     };
@@ -0,0 +1,340 @@
+/*
+ * This file is part of the Nepomuk KDE project.
+ * Copyright (c) 2009-2010 Sebastian Trueg <trueg@kde.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "olenatextextractiontask_p.h"
+#include "olenaresultcache_p.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QMetaObject>
+#include <QtCore/QMetaType>
+
+#include <QtGui/QImage>
+
+#include <KGlobal>
+#include <KDebug>
+
+#include "text_extraction.hh"
+
+namespace {
+/**
+ * We check two basic things:
+ * 1. is there any text at all
+ * 2. Is the letter/non-letter ratio useful - this is a primitive attempt to exclude garbage such as " W Y œe "ii" ï§ _* ,"
+ */
+bool checkText( const QString& text ) {
+    if(!text.isEmpty()) {
+        int letterCnt = 0;
+        int spaceCnt = 0;
+        Q_FOREACH(const QChar& c, text) {
+            if(c.isLetterOrNumber())
+                ++letterCnt;
+            else if(c.isSpace())
+                ++spaceCnt;
+        }
+        double letterRatio = double(letterCnt)/double(text.length());
+        double spaceRatio = double(spaceCnt)/double(text.length());
+        kDebug() << "Letter ration of" << text << letterRatio << spaceRatio;
+        return letterRatio > 0.7 && spaceRatio < 0.3;
+    }
+    else {
+        return false;
+    }
+}
+
+/**
+ * Forwards the lines recognized by the Olena pipeline to the job and keeps
+ * them for the result cache.
+ */
+class LineForwarder : public scribo::text::recognition_observer
+{
+public:
+    LineForwarder( Nepomuk::OlenaTaskLink* link, const KUrl& url )
+        : m_link( link ),
+          m_url( url ) {
+    }
+
+    void on_line_recognized( const std::string& text, const mln::box2d& bbox ) {
+        const QString line = QString::fromUtf8( text.c_str() );
+        const QRect rect( QPoint( bbox.pmin().col(), bbox.pmin().row() ),
+                          QPoint( bbox.pmax().col(), bbox.pmax().row() ) );
+        m_link->deliverLine( m_url, line, rect );
+
+        // the concurrent passes both report lines
+        QMutexLocker lock( &m_mutex );
+        m_lines.append( qMakePair( line, rect ) );
+    }
+
+    QList<QPair<QString, QRect> > lines() const {
+        QMutexLocker lock( &m_mutex );
+        return m_lines;
+    }
+
+private:
+    Nepomuk::OlenaTaskLink* m_link;
+    KUrl m_url;
+    mutable QMutex m_mutex;
+    QList<QPair<QString, QRect> > m_lines;
+};
+
+/**
+ * The parameters the extracted text depends on, as part of the result cache
+ * key. Bump the version whenever the pipeline output changes.
+ */
+QByteArray cacheParameters( const scribo::toolchain::nepomuk::text_extraction_params& params )
+{
+    return QByteArray( "olena-text-extraction-2" )
+        + ";lang=" + QByteArray( params.ocr_language.c_str() )
+        + ";deskew=" + QByteArray::number( params.deskew_min_angle )
+        + ";sauvola=" + QByteArray::number( params.sauvola_window )
+        + ";sauvola_scale=" + QByteArray::number( params.sauvola_scale )
+        + ";precheck=" + QByteArray::number( params.precheck_size )
+        + ',' + QByteArray::number( params.precheck_min_components );
+}
+
+class OlenaThreadPool : public QThreadPool
+{
+public:
+    OlenaThreadPool() {
+        qRegisterMetaType<KUrl>( "KUrl" );
+        // Keep the threads, and thus the OCR engines they use, warm between images.
+        setExpiryTimeout( 5*60*1000 );
+    }
+};
+}
+
+K_GLOBAL_STATIC( OlenaThreadPool, s_olenaThreadPool )
+
+
+QThreadPool* Nepomuk::olenaThreadPool()
+{
+    return s_olenaThreadPool;
+}
+
+
+Nepomuk::OlenaTaskLink::OlenaTaskLink( QObject* receiver )
+    : m_receiver( receiver )
+{
+}
+
+
+void Nepomuk::OlenaTaskLink::detach()
+{
+    QMutexLocker lock( &m_mutex );
+    m_receiver = 0;
+}
+
+
+bool Nepomuk::OlenaTaskLink::isDetached()
+{
+    QMutexLocker lock( &m_mutex );
+    return m_receiver == 0;
+}
+
+
+void Nepomuk::OlenaTaskLink::cancel()
+{
+    m_cancellation.cancel();
+}
+
+
+const scribo::cancellation_token& Nepomuk::OlenaTaskLink::cancellation() const
+{
+    return m_cancellation;
+}
+
+
+void Nepomuk::OlenaTaskLink::deliverLine( const KUrl& url, const QString& text, const QRect& rect )
+{
+    QMutexLocker lock( &m_mutex );
+    if ( m_receiver ) {
+        QMetaObject::invokeMethod( m_receiver, "slotLineRecognized", Qt::QueuedConnection,
+                                   Q_ARG( KUrl, url ),
+                                   Q_ARG( QString, text ),
+                                   Q_ARG( QRect, rect ) );
+    }
+}
+
+
+void Nepomuk::OlenaTaskLink::deliver( const KUrl& url, const QString& text )
+{
+    QMutexLocker lock( &m_mutex );
+    if ( m_receiver ) {
+        QMetaObject::invokeMethod( m_receiver, "slotTextExtracted", Qt::QueuedConnection,
+                                   Q_ARG( KUrl, url ),
+                                   Q_ARG( QString, text ) );
+    }
+}
+
+
+Nepomuk::OlenaTextExtractionTask::OlenaTextExtractionTask( const OlenaTaskLinkPtr& link,
+                                                           const KUrl& url,
+                                                           const QString& localPath )
+    : m_link( link ),
+      m_url( url ),
+      m_localPath( localPath ),
+      m_concurrentPasses( false ),
+      m_timeBudget( 0 ),
+      m_textPrecheck( true ),
+      m_binarizationThreads( 1 )
+{
+}
+
+
+Nepomuk::OlenaTextExtractionTask::OlenaTextExtractionTask( const OlenaTaskLinkPtr& link,
+                                                           const KUrl& url,
+                                                           const QByteArray& data )
+    : m_link( link ),
+      m_url( url ),
+      m_data( data ),
+      m_concurrentPasses( false ),
+      m_timeBudget( 0 ),
+      m_textPrecheck( true ),
+      m_binarizationThreads( 1 )
+{
+}
+
+
+void Nepomuk::OlenaTextExtractionTask::setConcurrentPasses( bool concurrent )
+{
+    m_concurrentPasses = concurrent;
+}
+
+
+void Nepomuk::OlenaTextExtractionTask::setTimeBudget( int msecs )
+{
+    m_timeBudget = msecs;
+}
+
+
+void Nepomuk::OlenaTextExtractionTask::setTextPrecheck( bool enabled )
+{
+    m_textPrecheck = enabled;
+}
+
+
+void Nepomuk::OlenaTextExtractionTask::setBinarizationThreads( int threads )
+{
+    m_binarizationThreads = threads;
+}
+
+
+QImage Nepomuk::OlenaTextExtractionTask::loadImage()
+{
+    if ( m_localPath.isEmpty() ) {
+        QImage image = QImage::fromData( m_data );
+        // the encoded data is not needed anymore
+        m_data.clear();
+        return image;
+    }
+
+    QFile file( m_localPath );
+    if ( !file.open( QIODevice::ReadOnly ) )
+        return QImage();
+
+    // decode straight from the page cache instead of reading the file into a buffer first
+    if ( uchar* data = file.map( 0, file.size() ) ) {
+        QImage image = QImage::fromData( data, file.size() );
+        file.unmap( data );
+        return image;
+    }
+
+    kDebug() << "Could not map" << m_localPath;
+    QImage image;
+    image.load( &file, 0 );
+    return image;
+}
+
+
+void Nepomuk::OlenaTextExtractionTask::run()
+{
+    QString text;
+    if ( m_link->cancellation().is_canceled() ) {
+        kDebug() << "Canceled before starting" << m_url;
+        m_link->deliver( m_url, text );
+        return;
+    }
+
+    // the budget only starts once the image is actually processed
+    scribo::cancellation_token cancellation( &m_link->cancellation() );
+    if ( m_timeBudget > 0 )
+        cancellation.set_time_budget( m_timeBudget );
+
+    LineForwarder lineForwarder( m_link.data(), m_url );
+
+    QImage image = loadImage();
+    if ( image.isNull() ) {
+        kDebug() << "Failed to load" << m_url;
+        m_link->deliver( m_url, text );
+        return;
+    }
+
+    scribo::toolchain::nepomuk::text_extraction_params params;
+    params.concurrent_passes = m_concurrentPasses;
+    // share the pool threads with the other images being processed, the
+    // concurrent passes each use as many
+    QThreadPool* pool = olenaThreadPool();
+    int threads = pool->maxThreadCount() / qMax( pool->activeThreadCount(), 1 );
+    if ( m_concurrentPasses )
+        threads /= 2;
+    params.binarization_nthreads = qBound( 1, threads, m_binarizationThreads );
+    params.ocr_nthreads = params.binarization_nthreads;
+    if ( !m_textPrecheck )
+        params.precheck_size = 0;
+    params.cancellation = &cancellation;
+    params.observer = &lineForwarder;
+
+    OlenaResultCache* cache = OlenaResultCache::global();
+    QByteArray cacheKey;
+    if ( cache->isEnabled() ) {
+        cacheKey = OlenaResultCache::key( image, cacheParameters( params ) );
+        OlenaResultCache::Entry entry;
+        if ( cache->lookup( cacheKey, &entry ) ) {
+            kDebug() << "Using the cached text of" << m_url;
+            for ( int i = 0; i < entry.lines.count(); ++i )
+                m_link->deliverLine( m_url, entry.lines[i].first, entry.lines[i].second );
+            m_link->deliver( m_url, entry.text );
+            return;
+        }
+    }
+
+    text = scribo::toolchain::nepomuk::text_extraction( image, params );
+    kDebug() << m_url << text;
+    if ( cancellation.is_canceled() )
+        kDebug() << "Canceled, keeping the partial text of" << m_url;
+    if(!checkText(text)) {
+        kDebug() << "Extracted text seems to be junk.";
+        text.truncate(0);
+    }
+
+    // partial results must not be reused
+    if ( !cacheKey.isEmpty() && !cancellation.is_canceled() ) {
+        OlenaResultCache::Entry entry;
+        entry.text = text;
+        entry.lines = lineForwarder.lines();
+        cache->insert( cacheKey, entry );
+    }
+
+    m_link->deliver( m_url, text );
+}
@@ -0,0 +1,128 @@
+/*
+ * This file is part of the Nepomuk KDE project.
+ * Copyright (c) 2009-2010 Sebastian Trueg <trueg@kde.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _OLENA_TEXT_EXTRACTION_TASK_P_H_
+#define _OLENA_TEXT_EXTRACTION_TASK_P_H_
+
+#include <QtCore/QRunnable>
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QRect>
+
+#include <KUrl>
+
+#include <scribo/core/cancellation_token.hh>
+
+class QObject;
+class QThreadPool;
+class QImage;
+
+namespace Nepomuk {
+    /**
+     * The thread pool shared by all the extraction jobs. Its maximum thread
+     * count bounds the number of images processed at the same time.
+     */
+    QThreadPool* olenaThreadPool();
+
+    /**
+     * State shared by a job and the tasks it queued in olenaThreadPool().
+     *
+     * Results are posted to the receiver's slotTextExtracted(KUrl, QString)
+     * and slotLineRecognized(KUrl, QString, QRect) through queued calls. The receiver detaches itself before going away
+     * so that late results are dropped.
+     */
+    class OlenaTaskLink
+    {
+    public:
+        OlenaTaskLink( QObject* receiver );
+
+        void detach();
+
+        /// Results posted before detach() still reach the receiver;
+        /// it drops them once this returns true.
+        bool isDetached();
+
+        /// Ask the tasks to stop as soon as possible.
+        void cancel();
+        const scribo::cancellation_token& cancellation() const;
+
+        /// Called by a task for each recognized line.
+        void deliverLine( const KUrl& url, const QString& text, const QRect& rect );
+
+        /// Called by a task when it is done.
+        void deliver( const KUrl& url, const QString& text );
+
+    private:
+        QMutex m_mutex;
+        QObject* m_receiver;
+        scribo::cancellation_token m_cancellation;
+    };
+
+    typedef QSharedPointer<OlenaTaskLink> OlenaTaskLinkPtr;
+
+    /**
+     * Extracts the text from one image, read from a local file or from
+     * the encoded data already downloaded by the job.
+     */
+    class OlenaTextExtractionTask : public QRunnable
+    {
+    public:
+        /// The file at \p localPath is memory-mapped when possible.
+        OlenaTextExtractionTask( const OlenaTaskLinkPtr& link,
+                                 const KUrl& url,
+                                 const QString& localPath );
+        OlenaTextExtractionTask( const OlenaTaskLinkPtr& link,
+                                 const KUrl& url,
+                                 const QByteArray& data );
+
+        /// Run the background and foreground passes concurrently.
+        void setConcurrentPasses( bool concurrent );
+
+        /// Stop after \p msecs milliseconds and deliver the text
+        /// recognized so far. 0 means no limit.
+        void setTimeBudget( int msecs );
+
+        /// Skip images that do not seem to contain any text.
+        void setTextPrecheck( bool enabled );
+
+        /// Binarize the image and recognize its text lines on at most
+        /// \p threads threads, fewer when other tasks are running in
+        /// olenaThreadPool().
+        void setBinarizationThreads( int threads );
+
+        void run();
+
+    private:
+        QImage loadImage();
+
+        OlenaTaskLinkPtr m_link;
+        KUrl m_url;
+        QString m_localPath;
+        QByteArray m_data;
+        bool m_concurrentPasses;
+        int m_timeBudget;
+        bool m_textPrecheck;
+        int m_binarizationThreads;
+    };
+}
+
+#endif
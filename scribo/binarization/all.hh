@@ -50,6 +50,7 @@ namespace scribo
 # include <scribo/binarization/sauvola.hh>
 # include <scribo/binarization/sauvola_ms.hh>
 # include <scribo/binarization/sauvola_ms_split.hh>
+# include <scribo/binarization/sauvola_streaming.hh>
 # include <scribo/binarization/sauvola_threshold_image.hh>
 
 #endif // ! SCRIBO_BINARIZATION_ALL_HH
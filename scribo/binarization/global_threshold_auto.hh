@@ -80,14 +80,87 @@ namespace scribo
     mln_ch_value(I, bool)
     global_threshold_auto(const Image<I>& input);
 
+    /// \overload
+    /// The histogram of 8-bit 2D images is computed on \p nthreads
+    /// threads if OpenMP is available.
+    //
+    template <typename I>
+    mln_ch_value(I, bool)
+    global_threshold_auto(const Image<I>& input, unsigned nthreads);
+
 
 
 # ifndef MLN_INCLUDE_ONLY
 
+    namespace internal
+    {
+
+      /// Count the values of a row of \p input on the watershed lines
+      /// of \p w.  Rows are numbered from 0 whatever the domain of
+      /// the images.
+      struct count_watershed_line_row
+      {
+	count_watershed_line_row(const image2d<value::int_u8>& input,
+				 const image2d<unsigned>& w)
+	  : input_(input), w_(w),
+	    pmin_(input.domain().pmin())
+	{
+	  mln_precondition(w.domain() == input.domain());
+	}
+
+	void operator()(int row, unsigned* h, unsigned, unsigned) const
+	{
+	  const unsigned char* v
+	    = reinterpret_cast<const unsigned char*>(
+	      & input_.at_(pmin_.row() + row, pmin_.col()));
+	  const unsigned* w = & w_.at_(pmin_.row() + row, pmin_.col());
+	  const unsigned ncols = input_.ncols();
+
+	  for (unsigned col = 0; col < ncols; ++col)
+	    if (w[col] == 0u)
+	      ++h[v[col]];
+	}
+
+	const image2d<value::int_u8>& input_;
+	const image2d<unsigned>& w_;
+	point2d pmin_;
+      };
+
+
+      /// Histogram of \p input on the watershed lines of \p w.
+      template <typename I, typename W>
+      inline
+      histo::array<mln_value(I)>
+      watershed_line_histo(const I& input, const W& w, unsigned)
+      {
+	return histo::compute(input | (pw::value(w) == pw::cst(0u)));
+      }
+
+      inline
+      histo::array<value::int_u8>
+      watershed_line_histo(const image2d<value::int_u8>& input,
+			   const image2d<unsigned>& w, unsigned nthreads)
+      {
+	return histo::impl::compute_by_rows<value::int_u8>(
+	  input.nrows(), count_watershed_line_row(input, w), nthreads);
+      }
+
+    } // end of namespace scribo::binarization::internal
+
+
+    template <typename I>
+    inline
+    mln_ch_value(I, bool)
+    global_threshold_auto(const Image<I>& input)
+    {
+      return global_threshold_auto(input, 1);
+    }
+
+
     template <typename I>
     inline
     mln_ch_value(I, bool)
-    global_threshold_auto(const Image<I>& input_)
+    global_threshold_auto(const Image<I>& input_, unsigned nthreads)
     {
       trace::entering("scribo::binarization::global_threshold_auto");
 
@@ -106,7 +179,7 @@ namespace scribo
 
 	unsigned nbasins;
 	mln_ch_value(I, unsigned) w = morpho::watershed::flooding(g, c4(), nbasins);
-	h = histo::compute(input | (pw::value(w) == pw::cst(0u)));
+	h = internal::watershed_line_histo(input, w, nthreads);
       }
 
 
@@ -33,9 +33,17 @@
 
 # include <algorithm>
 # include <cmath>
+# include <cstring>
+
+# if defined(__AVX__)
+#  include <immintrin.h>
+# elif defined(__SSE2__)
+#  include <emmintrin.h>
+# endif // ! __AVX__
 
 # include <mln/core/image/image2d.hh>
 # include <mln/value/int_u8.hh>
+# include <mln/convert/from_to.hh>
 
 # include <scribo/binarization/internal/sauvola_debug.hh>
 
@@ -78,26 +86,62 @@ namespace scribo
           \param[in] R Maximum value of the standard deviation (128
                        for grayscale documents).
 
+	  The integral images may have unsigned integer values, see
+	  scribo::integral_image: the window sums are computed in
+	  their value type before being converted to double.
+
 	  \return A threshold.
       */
-      template <typename P, typename J>
+      template <typename P, typename J, typename J2>
       double
       compute_sauvola_threshold(const P& p,
 				const J& simple,
-				const J& squared,
+				const J2& squared,
 				int win_width, double K, double R);
 
+      /// \overload
+      /// The local statistics are recorded in \p debug, if not null.
+      //
+      template <typename P, typename J, typename J2>
+      double
+      compute_sauvola_threshold(const P& p,
+				const J& simple,
+				const J2& squared,
+				int win_width, double K, double R,
+				sauvola_debug_sink* debug);
+
       /// \overload
       /// K is set to 0.34 and R to 128.
       //
-      template <typename P, typename J>
+      template <typename P, typename J, typename J2>
       double
       compute_sauvola_threshold(const P& p,
 				const J& simple,
-				const J& squared,
+				const J2& squared,
 				int win_width);
 
 
+      /*! \brief Compute Sauvola's thresholds of a run of pixels
+          whose windows have the same area.
+
+          \param[in] sum The sums of the values in each window.
+          \param[in] sum_2 The sums of the squared values in each
+                           window.
+          \param[in] n The number of pixels.
+          \param[in] wh The window area.
+          \param[in] K Sauvola's formulae parameter.
+          \param[in] R Maximum value of the standard deviation.
+          \param[out] t The \p n thresholds.
+
+          The thresholds are the same as the ones computed pixel per
+          pixel. Uses AVX or SSE2 when available.
+      */
+      void
+      sauvola_threshold_row(const double* sum, const double* sum_2,
+			    unsigned n, double wh, double K, double R,
+			    value::int_u8* t);
+
+
 
 # ifndef MLN_INCLUDE_ONLY
 
@@ -137,12 +181,25 @@ namespace scribo
 
 
 
-      template <typename P, typename J>
+      template <typename P, typename J, typename J2>
       double
       compute_sauvola_threshold(const P& p,
 				const J& simple,
-				const J& squared,
+				const J2& squared,
 				int win_width, double K, double R)
+      {
+	return compute_sauvola_threshold(p, simple, squared, win_width,
+					 K, R, 0);
+      }
+
+
+      template <typename P, typename J, typename J2>
+      double
+      compute_sauvola_threshold(const P& p,
+				const J& simple,
+				const J2& squared,
+				int win_width, double K, double R,
+				sauvola_debug_sink* debug)
       {
 	mln_precondition(simple.nrows() == squared.nrows());
 	mln_precondition(simple.ncols() == squared.ncols());
@@ -169,32 +226,21 @@ namespace scribo
 
 	double m_x_y = m_x_y_tmp / wh;
 
-#  ifdef SCRIBO_SAUVOLA_DEBUG
-	// Store local mean
-	debug_mean(p) = m_x_y * mean_debug_factor;
-#  endif // ! SCRIBO_SAUVOLA_DEBUG
-
 	// Standard deviation.
 	double s_x_y_tmp = (squared.at_(row_max, col_max)
 			    + squared.at_(row_min, col_min)
 			    - squared.at_(row_max, col_min)
 			    - squared.at_(row_min, col_max));
 
-	double s_x_y = std::sqrt((s_x_y_tmp - (m_x_y_tmp * m_x_y_tmp) / wh) / (wh - 1.f));
-
-#  ifdef SCRIBO_SAUVOLA_DEBUG
-	// Store local standard deviation
-	debug_stddev(p) = s_x_y * stddev_debug_factor;
-#  endif // ! SCRIBO_SAUVOLA_DEBUG
+	// Rounding may make the variance slightly negative.
+	double v_x_y = s_x_y_tmp - (m_x_y_tmp * m_x_y_tmp) / wh;
+	double s_x_y = v_x_y > 0 ? std::sqrt(v_x_y / (wh - 1.f)) : 0;
 
 	// Thresholding.
 	double t_x_y = sauvola_threshold_formula(m_x_y, s_x_y, K, R);
 
-#  ifdef SCRIBO_SAUVOLA_DEBUG
-	double alpha = K * (1 - s_x_y / R);
-	debug_alpham(p) = alpha * m_x_y * alpham_debug_factor;
-	debug_alphacond(p) = (s_x_y < (alpha * m_x_y / 2.));
-#  endif // !SCRIBO_SAUVOLA_DEBUG
+	if (debug)
+	  debug->store_stats(p, m_x_y, s_x_y, t_x_y, K, R);
 
 	return t_x_y;
       }
@@ -229,43 +275,29 @@ namespace scribo
 
 	double m_x_y = m_x_y_tmp / wh;
 
-#  ifdef SCRIBO_SAUVOLA_DEBUG
-	// Store local mean
-	debug_mean(p) = m_x_y * mean_debug_factor;
-#  endif // ! SCRIBO_SAUVOLA_DEBUG
-
 	// Standard deviation.
 	double s_x_y_tmp = (integral.at_(row_max, col_max).second()
 			    + integral.at_(row_min, col_min).second()
 			    - integral.at_(row_max, col_min).second()
 			    - integral.at_(row_min, col_max).second());
 
-	double s_x_y = std::sqrt((s_x_y_tmp - (m_x_y_tmp * m_x_y_tmp) / wh) / (wh - 1.f));
-
-#  ifdef SCRIBO_SAUVOLA_DEBUG
-	// Store local standard deviation
-	debug_stddev(p) = s_x_y * stddev_debug_factor;
-#  endif // !SCRIBO_SAUVOLA_DEBUG
+	// Rounding may make the variance slightly negative.
+	double v_x_y = s_x_y_tmp - (m_x_y_tmp * m_x_y_tmp) / wh;
+	double s_x_y = v_x_y > 0 ? std::sqrt(v_x_y / (wh - 1.f)) : 0;
 
 	// Thresholding.
 	double t_x_y = sauvola_threshold_formula(m_x_y, s_x_y, K, R);
 
-#  ifdef SCRIBO_SAUVOLA_DEBUG
-	double alpha = K * (1 - s_x_y / R);
-	debug_alpham(p) = alpha * m_x_y * alpham_debug_factor;
-	debug_alphacond(p) = (s_x_y < (alpha * m_x_y / 2.));
-#  endif // !SCRIBO_SAUVOLA_DEBUG
-
 	return t_x_y;
       }
 
 
 
-      template <typename P, typename J>
+      template <typename P, typename J, typename J2>
       double
       compute_sauvola_threshold(const P& p,
 				const J& simple,
-				const J& squared,
+				const J2& squared,
 				int win_width)
       {
 	return compute_sauvola_threshold(p, simple, squared, win_width,
@@ -274,6 +306,115 @@ namespace scribo
       }
 
 
+#  if defined(__SSE2__) || defined(__AVX__)
+
+      /// Store the 4 thresholds of \p t, rounded and converted as
+      /// mln::convert::from_to does, i.e. modulo 256.
+      inline
+      void
+      sauvola_store_thresholds(__m128i t, unsigned char* out)
+      {
+	t = _mm_and_si128(t, _mm_set1_epi32(0xff));
+	t = _mm_packs_epi32(t, t);
+	t = _mm_packus_epi16(t, t);
+	int v = _mm_cvtsi128_si32(t);
+	std::memcpy(out, &v, 4);
+      }
+
+#  endif // ! __SSE2__ || __AVX__
+
+
+      inline
+      void
+      sauvola_threshold_row(const double* sum, const double* sum_2,
+			    unsigned n, double wh, double K, double R,
+			    value::int_u8* t)
+      {
+	mln_precondition(sizeof(value::int_u8) == 1);
+
+	unsigned i = 0;
+
+	// The operations are those of compute_sauvola_threshold and
+	// sauvola_threshold_formula, in the same order, so that the
+	// results are bit-identical.
+#  if defined(__AVX__)
+	unsigned char* out = reinterpret_cast<unsigned char*>(t);
+	const __m256d
+	  v_wh = _mm256_set1_pd(wh),
+	  v_wh_1 = _mm256_set1_pd(wh - 1.),
+	  v_K = _mm256_set1_pd(K),
+	  v_R = _mm256_set1_pd(R),
+	  v_one = _mm256_set1_pd(1.0),
+	  v_zero = _mm256_setzero_pd(),
+	  v_round = _mm256_set1_pd(0.49999);
+
+	for (; i + 4 <= n; i += 4)
+	{
+	  __m256d s = _mm256_loadu_pd(sum + i);
+	  __m256d s_2 = _mm256_loadu_pd(sum_2 + i);
+
+	  __m256d m = _mm256_div_pd(s, v_wh);
+	  __m256d var = _mm256_sub_pd(s_2,
+				      _mm256_div_pd(_mm256_mul_pd(s, s), v_wh));
+	  __m256d sd = _mm256_sqrt_pd(_mm256_div_pd(_mm256_max_pd(var, v_zero),
+						    v_wh_1));
+	  __m256d th =
+	    _mm256_mul_pd(m,
+			  _mm256_add_pd(v_one,
+					_mm256_mul_pd(v_K,
+						      _mm256_sub_pd(_mm256_div_pd(sd, v_R),
+								    v_one))));
+
+	  sauvola_store_thresholds(_mm256_cvttpd_epi32(_mm256_add_pd(th, v_round)),
+				   out + i);
+	}
+#  elif defined(__SSE2__)
+	unsigned char* out = reinterpret_cast<unsigned char*>(t);
+	const __m128d
+	  v_wh = _mm_set1_pd(wh),
+	  v_wh_1 = _mm_set1_pd(wh - 1.),
+	  v_K = _mm_set1_pd(K),
+	  v_R = _mm_set1_pd(R),
+	  v_one = _mm_set1_pd(1.0),
+	  v_zero = _mm_setzero_pd(),
+	  v_round = _mm_set1_pd(0.49999);
+
+	for (; i + 4 <= n; i += 4)
+	{
+	  __m128i th_i[2];
+	  for (unsigned j = 0; j < 2; ++j)
+	  {
+	    __m128d s = _mm_loadu_pd(sum + i + 2 * j);
+	    __m128d s_2 = _mm_loadu_pd(sum_2 + i + 2 * j);
+
+	    __m128d m = _mm_div_pd(s, v_wh);
+	    __m128d var = _mm_sub_pd(s_2, _mm_div_pd(_mm_mul_pd(s, s), v_wh));
+	    __m128d sd = _mm_sqrt_pd(_mm_div_pd(_mm_max_pd(var, v_zero), v_wh_1));
+	    __m128d th =
+	      _mm_mul_pd(m,
+			 _mm_add_pd(v_one,
+				    _mm_mul_pd(v_K,
+					       _mm_sub_pd(_mm_div_pd(sd, v_R),
+							  v_one))));
+
+	    th_i[j] = _mm_cvttpd_epi32(_mm_add_pd(th, v_round));
+	  }
+
+	  sauvola_store_thresholds(_mm_unpacklo_epi64(th_i[0], th_i[1]),
+				   out + i);
+	}
+#  endif // ! __AVX__
+
+	for (; i < n; ++i)
+	{
+	  double m = sum[i] / wh;
+	  double var = sum_2[i] - (sum[i] * sum[i]) / wh;
+	  double sd = var > 0 ? std::sqrt(var / (wh - 1.)) : 0;
+	  mln::convert::from_to(sauvola_threshold_formula(m, sd, K, R), t[i]);
+	}
+      }
+
+
 #endif // ! MLN_INCLUDE_ONLY
 
     } // end of namespace scribo::binarization::internal
@@ -71,7 +71,49 @@ namespace scribo
 	first_pass_functor(const I& input, double K);
 
 	void exec(double mean, double stddev);
+	void exec_row(const double* sum, const double* sum_2,
+		      unsigned n, double wh);
 	void finalize();
+
+	/// Link the components of \p msk, in raster order, once its
+	/// rows have been computed with first_pass_band_functor
+	/// instead of this functor.
+	void link_components();
+
+      private:
+	/// Process the current pixel, given its threshold.
+	void exec_threshold(const value::int_u8& t_p);
+
+	/// Merge the component of \p p with its preceding neighbors.
+	void link(unsigned p);
+      };
+
+
+      /// Compute the thresholds and the mask of a band of rows of a
+      /// first_pass_functor, without linking the components.
+      ///
+      /// Bands can be computed concurrently; the components are
+      /// linked afterwards with first_pass_functor::link_components().
+      template <typename I>
+      struct first_pass_band_functor
+      {
+	first_pass_band_functor(first_pass_functor<I>& f,
+				unsigned row_begin);
+
+	void exec(double mean, double stddev);
+	void exec_row(const double* sum, const double* sum_2,
+		      unsigned n, double wh);
+	void finalize();
+
+      private:
+	/// Process the current pixel, given its threshold.
+	void exec_threshold(const value::int_u8& t_p);
+
+	first_pass_functor<I>& f_;
+	unsigned p_;
+	unsigned col_;
+	const unsigned ncols_;
+	const unsigned next_row_;
       };
 
 
@@ -100,11 +142,6 @@ namespace scribo
 	initialize(parent, input);
 	initialize(msk, input);
 
-# ifdef SCRIBO_SAUVOLA_DEBUG
-	initialize(debug_mean, input);
-	initialize(debug_stddev, input);
-# endif // ! SCRIBO_SAUVOLA_DEBUG
-
 	mln::extension::fill(msk, false);
 
 	initialize(card, input);
@@ -121,21 +158,53 @@ namespace scribo
       {
 	mln_precondition(pxl.is_valid());
 
-	unsigned p = pxl.offset();
-
 	value::int_u8 t_p;
 	mln::convert::from_to(sauvola_threshold_formula(mean, stddev,
 							K_,
 							SCRIBO_DEFAULT_SAUVOLA_R),
 			      t_p);
 
+	exec_threshold(t_p);
+      }
+
+
+      template <typename I>
+      void
+      first_pass_functor<I>::exec_row(const double* sum,
+				      const double* sum_2,
+				      unsigned n, double wh)
+      {
+	mln_precondition(pxl.is_valid());
+
+	// The run is contiguous in t_sub.
+	value::int_u8* t = &t_sub.element(pxl.offset());
+	sauvola_threshold_row(sum, sum_2, n, wh, K_,
+			      SCRIBO_DEFAULT_SAUVOLA_R, t);
+
+	for (unsigned i = 0; i < n; ++i)
+	  exec_threshold(t[i]);
+      }
+
+
+      template <typename I>
+      void
+      first_pass_functor<I>::exec_threshold(const value::int_u8& t_p)
+      {
+	unsigned p = pxl.offset();
+
 	msk.element(p) = input.element(p) < t_p;
 	t_sub.element(p) = t_p;
-	if (! msk.element(p))
-	{
-	  pxl.next();
-	  return;
-	}
+	if (msk.element(p))
+	  link(p);
+
+	pxl.next(); // next pixel
+      }
+
+
+      template <typename I>
+      void
+      first_pass_functor<I>::link(unsigned p)
+      {
 	parent.element(p) = p;
 	for (unsigned i = 0; i < n_nbhs; ++i)
 	{
@@ -149,8 +218,6 @@ namespace scribo
 	    card.element(p) += card.element(r);
 	  }
 	}
-
-	pxl.next(); // next pixel
       }
 
 
@@ -160,6 +227,85 @@ namespace scribo
 	mln_assertion(! pxl.is_valid());
       }
 
+
+      template <typename I>
+      void
+      first_pass_functor<I>::link_components()
+      {
+	for (; pxl.is_valid(); pxl.next())
+	{
+	  unsigned p = pxl.offset();
+	  if (msk.element(p))
+	    link(p);
+	}
+      }
+
+
+      // first_pass_band_functor
+
+      template <typename I>
+      first_pass_band_functor<I>::first_pass_band_functor(first_pass_functor<I>& f,
+							  unsigned row_begin)
+	: f_(f),
+	  col_(0),
+	  ncols_(f.t_sub.ncols()),
+	  next_row_(f.t_sub.delta_index(dpoint2d(+1, - f.t_sub.ncols())))
+      {
+	p_ = f.t_sub.index_of_point(point2d(row_begin, 0));
+      }
+
+
+      template <typename I>
+      void
+      first_pass_band_functor<I>::exec(double mean, double stddev)
+      {
+	value::int_u8 t_p;
+	mln::convert::from_to(sauvola_threshold_formula(mean, stddev,
+							f_.K_,
+							SCRIBO_DEFAULT_SAUVOLA_R),
+			      t_p);
+
+	exec_threshold(t_p);
+      }
+
+
+      template <typename I>
+      void
+      first_pass_band_functor<I>::exec_row(const double* sum,
+					   const double* sum_2,
+					   unsigned n, double wh)
+      {
+	// Runs never span several rows.
+	value::int_u8* t = &f_.t_sub.element(p_);
+	sauvola_threshold_row(sum, sum_2, n, wh, f_.K_,
+			      SCRIBO_DEFAULT_SAUVOLA_R, t);
+
+	for (unsigned i = 0; i < n; ++i)
+	  exec_threshold(t[i]);
+      }
+
+
+      template <typename I>
+      void
+      first_pass_band_functor<I>::exec_threshold(const value::int_u8& t_p)
+      {
+	f_.msk.element(p_) = f_.input.element(p_) < t_p;
+	f_.t_sub.element(p_) = t_p;
+
+	++p_;
+	if (++col_ == ncols_)
+	{
+	  p_ += next_row_;
+	  col_ = 0;
+	}
+      }
+
+
+      template <typename I>
+      void first_pass_band_functor<I>::finalize()
+      {
+      }
+
 #endif // ! MLN_INCLUDE_ONLY
 
     } // end of namespace scribo::binarization::internal
@@ -28,16 +28,12 @@
 
 /// \file
 ///
-/// \brief Declare all debug related variables for Sauvola*
-/// algorithms.
+/// \brief Debug output of Sauvola* algorithms.
 
-
-/// FIXME: A struct may be a bit better...
-
-
-# ifdef SCRIBO_SAUVOLA_DEBUG
-
-#  ifndef MLN_INCLUDE_ONLY
+# include <mln/core/image/image2d.hh>
+# include <mln/core/routine/initialize.hh>
+# include <mln/value/int_u8.hh>
+# include <mln/util/array.hh>
 
 
 namespace scribo
@@ -48,40 +44,106 @@ namespace scribo
 
     using namespace mln;
 
-    namespace internal
+
+    /*! \brief Intermediate images of Sauvola's binarizations.
+
+      A sink is passed to sauvola(), sauvola_threshold_image() or
+      sauvola_ms() to capture their intermediate images. It belongs
+      to a single call, so that binarizations can run concurrently.
+      Without a sink, nothing is captured.
+
+      Capturing the local statistics disables the vectorized
+      computation of the thresholds.
+     */
+    struct sauvola_debug_sink
     {
+      sauvola_debug_sink();
 
-      char* stddev_image_output = 0;
-      char* mean_image_output = 0;
-      char* threshold_image_output = 0;
+      /// Allocate the images of the local statistics.
+      template <typename I>
+      void init_stats(const I& input);
 
-      char* scale_image_output = 0;
+      /// Record the local statistics of \p p.
+      template <typename P>
+      void store_stats(const P& p, double mean, double stddev,
+		       double threshold, double K, double R);
 
-      char* alpham_image_output = 0;
-      char* alphacond_image_output = 0;
 
-      // Declare debug images.
-      image2d<double> debug_stddev;
-      image2d<double> debug_mean;
-      image2d<double> debug_threshold;
+      /// \{
+      /// Local statistics, computed by sauvola() and
+      /// sauvola_threshold_image().
+      image2d<double> mean;
+      image2d<double> stddev;
+      image2d<double> threshold;
+      image2d<double> alpham;
+      image2d<bool> alphacond;
+      /// \}
 
-      image2d<double> debug_alpham;
-      image2d<bool> debug_alphacond;
+      /// \{
+      /// Computed by sauvola_ms(): the foreground pixels found at
+      /// each scale, indexed by scale, and the scale selected for each
+      /// pixel at scale 2, before the propagation.
+      util::array<image2d<bool> > scale_objects;
+      image2d<value::int_u8> scale;
+      /// \}
 
-      double mean_debug_factor = 1.0;
-      double stddev_debug_factor = 1.0;
-      double alpham_debug_factor = 2.0;
+      /// Factors applied to the stored statistics.
+      double mean_factor;
+      double stddev_factor;
+      double alpham_factor;
+    };
 
-    } // end of namespace scribo::binarization::internal
 
-  } // end of namespace scribo::binarization
 
-} // end of namespace scribo
+#  ifndef MLN_INCLUDE_ONLY
+
+
+    inline
+    sauvola_debug_sink::sauvola_debug_sink()
+      : mean_factor(1.0),
+	stddev_factor(1.0),
+	alpham_factor(2.0)
+    {
+    }
+
+
+    template <typename I>
+    inline
+    void
+    sauvola_debug_sink::init_stats(const I& input)
+    {
+      initialize(mean, input);
+      initialize(stddev, input);
+      initialize(threshold, input);
+      initialize(alpham, input);
+      initialize(alphacond, input);
+    }
+
+
+    template <typename P>
+    inline
+    void
+    sauvola_debug_sink::store_stats(const P& p, double m_x_y, double s_x_y,
+				    double t_x_y, double K, double R)
+    {
+      if (! mean.is_valid())
+	return;
+
+      mean(p) = m_x_y * mean_factor;
+      stddev(p) = s_x_y * stddev_factor;
+      threshold(p) = t_x_y;
+
+      double alpha = K * (1 - s_x_y / R);
+      alpham(p) = alpha * m_x_y * alpham_factor;
+      alphacond(p) = (s_x_y < (alpha * m_x_y / 2.));
+    }
 
 
 #  endif // ! MLN_INCLUDE_ONLY
 
-# endif // ! SCRIBO_SAUVOLA_DEBUG
+  } // end of namespace scribo::binarization
+
+} // end of namespace scribo
 
 
 #endif // ! SCRIBO_BINARIZATION_INTERNAL_SAUVOLA_DEBUG_HH
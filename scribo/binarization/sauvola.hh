@@ -39,12 +39,6 @@
 # include <scribo/binarization/local_threshold.hh>
 # include <scribo/binarization/internal/sauvola_debug.hh>
 
-# ifdef SCRIBO_SAUVOLA_DEBUG
-#  include <mln/io/pgm/save.hh>
-#  include <mln/io/pbm/save.hh>
-#  include <mln/data/saturate.hh>
-# endif // ! SCRIBO_SAUVOLA_DEBUG
-
 namespace scribo
 {
 
@@ -68,6 +62,15 @@ namespace scribo
     sauvola(const Image<I>& input, unsigned window_size, double K);
 
 
+    /// \overload
+    /// The local statistics are recorded in \p debug, if not null.
+    //
+    template <typename I>
+    mln_ch_value(I, bool)
+    sauvola(const Image<I>& input, unsigned window_size, double K,
+	    sauvola_debug_sink* debug);
+
+
 
     /*! \brief Convert an image into a binary image.
 
@@ -105,7 +108,8 @@ namespace scribo
 
 	template <typename I>
 	mln_ch_value(I, bool)
-	sauvola(const Image<I>& input, unsigned window_size, double K)
+	sauvola(const Image<I>& input, unsigned window_size, double K,
+		sauvola_debug_sink* debug)
 	{
 	  trace::entering("scribo::binarization::impl::generic::sauvola");
 	  mln_precondition(exact(input).is_valid());
@@ -114,7 +118,8 @@ namespace scribo
 	    output = local_threshold(input,
 				     binarization::sauvola_threshold_image(input,
 									   window_size,
-									   K));
+									   K,
+									   debug));
 
 	  trace::exiting("scribo::binarization::impl::generic::sauvola");
 	  return output;
@@ -136,19 +141,19 @@ namespace scribo
       mln_ch_value(I, bool)
 	sauvola_dispatch(const mln_value(I)&,
 			 const Image<I>& input, unsigned window_size,
-			 double K)
+			 double K, sauvola_debug_sink* debug)
       {
-	return impl::generic::sauvola(input, window_size, K);
+	return impl::generic::sauvola(input, window_size, K, debug);
       }
 
 
       template <typename I>
       mln_ch_value(I, bool)
       sauvola_dispatch(const Image<I>& input, unsigned window_size,
-		       double K)
+		       double K, sauvola_debug_sink* debug)
       {
 	typedef mln_value(I) V;
-	return sauvola_dispatch(V(), input, window_size, K);
+	return sauvola_dispatch(V(), input, window_size, K, debug);
       }
 
     } // end of namespace scribo::binarization::internal
@@ -160,31 +165,22 @@ namespace scribo
     template <typename I>
     mln_ch_value(I, bool)
       sauvola(const Image<I>& input, unsigned window_size, double K)
+    {
+      return sauvola(input, window_size, K, 0);
+    }
+
+
+    template <typename I>
+    mln_ch_value(I, bool)
+    sauvola(const Image<I>& input, unsigned window_size, double K,
+	    sauvola_debug_sink* debug)
     {
       trace::entering("scribo::binarization::sauvola");
 
       mln_precondition(exact(input).is_valid());
 
       mln_ch_value(I, bool)
-	output = internal::sauvola_dispatch(input, window_size, K);
-
-# ifdef SCRIBO_SAUVOLA_DEBUG
-      if (internal::stddev_image_output)
-	io::pgm::save(data::saturate(value::int_u8(), internal::debug_stddev),
-		      internal::stddev_image_output);
-      if (internal::mean_image_output)
-	io::pgm::save(data::saturate(value::int_u8(), internal::debug_mean),
-		      internal::mean_image_output);
-      if (internal::threshold_image_output)
-	io::pgm::save(data::saturate(value::int_u8(), internal::debug_threshold),
-		      internal::threshold_image_output);
-
-      if (internal::alpham_image_output)
-	io::pgm::save(data::saturate(value::int_u8(), internal::debug_alpham),
-		      internal::alpham_image_output);
-      if (internal::alphacond_image_output)
-	io::pbm::save(internal::debug_alphacond, internal::alphacond_image_output);
-# endif // ! SCRIBO_SAUVOLA_DEBUG
+	output = internal::sauvola_dispatch(input, window_size, K, debug);
 
 
       trace::exiting("scribo::binarization::sauvola");
@@ -59,17 +59,15 @@
 # include <scribo/subsampling/integral_single_image.hh>
 
 # include <scribo/core/macros.hh>
+# include <scribo/core/integral_image.hh>
 
+# include <scribo/binarization/sauvola.hh>
 # include <scribo/binarization/sauvola_threshold_image.hh>
 # include <scribo/binarization/internal/first_pass_functor.hh>
 
-# include <scribo/canvas/integral_browsing.hh>
+# include <scribo/binarization/internal/sauvola_debug.hh>
 
-# ifdef SCRIBO_SAUVOLA_DEBUG
-#  include <scribo/binarization/internal/sauvola_debug.hh>
-#  include <mln/io/pgm/save.hh>
-#  include <scribo/make/debug_filename.hh>
-# endif // ! SCRIBO_SAUVOLA_DEBUG
+# include <scribo/canvas/integral_browsing.hh>
 
 
 
@@ -83,6 +81,21 @@ namespace scribo
     using value::int_u8;
 
 
+    /// \brief The first subscale of sauvola_ms() and its integral
+    /// images, computed by sauvola_ms_read().
+    //
+    struct sauvola_ms_first_scale
+    {
+      sauvola_ms_first_scale();
+
+      /// The scale factor of \p sub.
+      unsigned s;
+
+      image2d<int_u8> sub;
+      integral_image integral;
+    };
+
+
     /*! \brief Binarize an image using a multi-scale implementation of
         Sauvola's algoritm.
 
@@ -96,6 +109,9 @@ namespace scribo
       \p w_1 and \p lambda_min_1 are expressed according to the image
       at scale 0, i.e. the original size.
 
+      Images at most 4 * \p s pixels high or wide are binarized with
+      sauvola() at a single scale.
+
       \return A Boolean image.
      */
     template <typename I>
@@ -109,11 +125,78 @@ namespace scribo
     mln_ch_value(I,bool)
     sauvola_ms(const Image<I>& input_1, unsigned w_1, unsigned s);
 
+    /*! \overload
+
+      The thresholds of each scale and the final binarization are
+      computed on \p nthreads threads, by bands of rows. The output
+      is the same as with a single thread.
+
+      OpenMP is required; without it, or if \p nthreads is lower than
+      2, the binarization is done serially.
+     */
+    template <typename I>
+    mln_ch_value(I,bool)
+    sauvola_ms(const Image<I>& input_1, unsigned w_1, unsigned s, double K,
+	       unsigned nthreads);
+
+    /// \overload
+    /// The intermediate results are recorded in \p debug, if not null.
+    //
+    template <typename I>
+    mln_ch_value(I,bool)
+    sauvola_ms(const Image<I>& input_1, unsigned w_1, unsigned s, double K,
+	       unsigned nthreads, sauvola_debug_sink* debug);
+
+    /*! \overload
+
+      The first subscale of \p input_1 is not computed again if \p
+      first was computed by sauvola_ms_read() for the same image and
+      scale factor \p s. Otherwise, \p first is ignored.
+     */
+    image2d<bool>
+    sauvola_ms(const image2d<int_u8>& input_1, unsigned w_1, unsigned s,
+	       double K, unsigned nthreads,
+	       const sauvola_ms_first_scale& first);
+
+
+    /*! \brief Read a gray level image row by row and compute the
+      first subscale of sauvola_ms() in the same sweep.
+
+      Each block of \p s rows is subsampled and integrated right after
+      it is read, while it is still in cache, so that sauvola_ms()
+      does not read the whole image again to do it.
+
+      \param[in,out] source A functor providing the rows of the image
+                            from top to bottom through
+                            source.read_row(value::int_u8* row).
+      \param[in]     nrows  The number of rows of the image.
+      \param[in]     ncols  The number of columns of the image.
+      \param[in]     s      The scale factor which will be given to
+                            sauvola_ms(), 2 or 3.
+      \param[out]    first  The first subscale of the image. It is
+                            left empty for images too small to be
+                            subsampled by sauvola_ms().
+
+      \return The gray level image, with the border sauvola_ms()
+      needs.
+     */
+    template <typename S>
+    image2d<int_u8>
+    sauvola_ms_read(S& source, unsigned nrows, unsigned ncols, unsigned s,
+		    sauvola_ms_first_scale& first);
+
 
 
 # ifndef MLN_INCLUDE_ONLY
 
 
+    inline
+    sauvola_ms_first_scale::sauvola_ms_first_scale()
+      : s(0)
+    {
+    }
+
+
     // Routines
 
     namespace internal
@@ -132,14 +215,101 @@ namespace scribo
       }
 
 
+      /// Height of the bands of rows processed in parallel, a few
+      /// bands per thread to balance the load.
+      inline
+      int
+      band_height(int nrows, unsigned nthreads)
+      {
+	const int nbands = 4 * nthreads;
+	return std::max(1, (nrows + nbands - 1) / nbands);
+      }
+
+
+#  ifdef _OPENMP
+
+      /// Parallel version of the 2nd pass of compute_t_n_and_e_2.
+      ///
+      /// The serial pass relies on the backward browsing to get the
+      /// decision of a pixel from its parent.  Here, the roots decide
+      /// first, and then each pixel gets the decision of its root.
+      inline
+      void
+      second_pass_rows(first_pass_functor< image2d<int_u8> >& f,
+		       image2d<int_u8>& e_2,
+		       unsigned lambda_min, unsigned lambda_max,
+		       unsigned ratio, unsigned i, unsigned nthreads)
+      {
+	const image2d<int_u8>& sub = f.input;
+	const image2d<unsigned>& parent = f.parent;
+	const image2d<unsigned>& card = f.card;
+	image2d<bool>& msk = f.msk;
+
+	const int
+	  nrows = sub.nrows(),
+	  ncols = sub.ncols(),
+	  e_2_nrows = e_2.nrows();
+
+#   pragma omp parallel num_threads(nthreads)
+	{
+#   pragma omp for schedule(static)
+	  for (int row = 0; row < nrows; ++row)
+	  {
+	    unsigned p = sub.index_of_point(point2d(row, 0));
+	    for (int col = 0; col < ncols; ++col, ++p)
+	      if (msk.element(p) && parent.element(p) == p)
+	      {
+		// test over the component cardinality
+		msk.element(p) = card.element(p) > lambda_min
+		  && card.element(p) < lambda_max;
+	      }
+	  }
+
+	  // Only the roots are read by other threads from now on.
+#   pragma omp for schedule(static)
+	  for (int row = 0; row < nrows; ++row)
+	  {
+	    const int
+	      e_2_row = row * ratio,
+	      e_2_height = std::min(int(ratio), e_2_nrows - e_2_row);
+
+	    unsigned p = sub.index_of_point(point2d(row, 0));
+	    for (int col = 0; col < ncols; ++col, ++p)
+	    {
+	      if (! msk.element(p))
+		continue;
+
+	      if (parent.element(p) != p)
+	      {
+		// Propagation
+		unsigned r = parent.element(p);
+		while (parent.element(r) != r)
+		  r = parent.element(r);
+		msk.element(p) = msk.element(r);
+	      }
+
+	      int_u8* e = & e_2.at_(e_2_row, col * ratio);
+	      if (msk.element(p) && *e == 0u)
+		for (int l = 0; l < e_2_height; ++l)
+		  std::memset(& e_2.at_(e_2_row + l, col * ratio), i,
+			      ratio * sizeof(int_u8));
+	    }
+	  }
+	}
+      }
+
+#  endif // ! _OPENMP
+
+
       inline
       image2d<int_u8>
       compute_t_n_and_e_2(const image2d<int_u8>& sub, image2d<int_u8>& e_2,
 			  unsigned lambda_min, unsigned lambda_max,
 			  unsigned s,
 			  unsigned q, unsigned i, unsigned w,
-			  const image2d<util::couple<double,double> >& integral_sum_sum_2,
-			  double K)
+			  const integral_image& integral_sum_sum_2,
+			  double K, unsigned nthreads,
+			  sauvola_debug_sink* debug)
       {
 	typedef image2d<int_u8> I;
 	typedef point2d P;
@@ -180,117 +350,266 @@ namespace scribo
 	// 1st pass
 	scribo::binarization::internal::first_pass_functor< image2d<int_u8> >
 	  f(sub, K);
-	scribo::canvas::integral_browsing(integral_sum_sum_2,
-					  ratio,
-					  w_local_w, w_local_h,
-					  s,
-					  f);
 
-	// 2nd pass
+#  ifdef _OPENMP
+	if (nthreads > 1)
 	{
-	  util::array<mln_value_(I) *> ptr(ratio);
-	  unsigned nrows = geom::nrows(e_2);
-
-	  mln_box_runend_piter_(I) sp(sub.domain()); // Backward.
-	  unsigned ncols = sp.run_length();
-	  for_all(sp)
+	  // The thresholds of bands of rows are computed in parallel
+	  // and the components are linked afterwards.
+	  const int
+	    nrows = sub.nrows(),
+	    band = band_height(nrows, nthreads),
+	    nbands = (nrows + band - 1) / band;
+
+#   pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+	  for (int b = 0; b < nbands; ++b)
 	  {
-	    unsigned p = &sub(sp) - sub.buffer(); // Offset
-	    P site = sp;
+	    first_pass_band_functor< image2d<int_u8> > f_b(f, b * band);
+	    scribo::canvas::integral_browsing(integral_sum_sum_2,
+					      ratio,
+					      w_local_w, w_local_h,
+					      s,
+					      b * band,
+					      std::min(nrows, (b + 1) * band),
+					      f_b);
+	  }
 
-	    {
-	      P tmp = site * ratio;
+	  f.link_components();
 
-	      // FIXME: to be removed!
-	      if (tmp.row() + ratio >= nrows)
-		ptr.resize(nrows - tmp.row());
+	  // 2nd pass
+	  second_pass_rows(f, e_2, lambda_min, lambda_max, ratio, i,
+			   nthreads);
+	}
+	else
+#  else
+	(void) nthreads;
+#  endif // ! _OPENMP
+	{
+	  scribo::canvas::integral_browsing(integral_sum_sum_2,
+					    ratio,
+					    w_local_w, w_local_h,
+					    s,
+					    f);
 
-	      ptr(0) = &e_2(tmp);
-	      // FIXME: pointers could just be updated with an offset.
-	      for (unsigned j = 1; j < ptr.size(); ++j)
-	      {
-		tmp[0] += 1;
-		ptr(j) = & e_2(tmp);
-	      }
-	    }
+	  // 2nd pass
+	  {
+	    util::array<mln_value_(I) *> ptr(ratio);
+	    unsigned nrows = geom::nrows(e_2);
 
-	    for (unsigned j = 0; j < ncols; ++j)
+	    mln_box_runend_piter_(I) sp(sub.domain()); // Backward.
+	    unsigned ncols = sp.run_length();
+	    for_all(sp)
 	    {
-	      if (f.msk.element(p))
+	      unsigned p = &sub(sp) - sub.buffer(); // Offset
+	      P site = sp;
+
 	      {
+		P tmp = site * ratio;
 
-		mln_site_(I) sq = site * ratio;
+		// FIXME: to be removed!
+		if (tmp.row() + ratio >= nrows)
+		  ptr.resize(nrows - tmp.row());
 
-		if (f.parent.element(p) == p)
+		ptr(0) = &e_2(tmp);
+		// FIXME: pointers could just be updated with an offset.
+		for (unsigned j = 1; j < ptr.size(); ++j)
 		{
-		  // test over the component cardinality
-		  f.msk.element(p) = f.card.element(p) > lambda_min
-		    && f.card.element(p) < lambda_max;
-
-		  if (f.msk.element(p) && e_2(sq) == 0u)
-		  {
-		    for (unsigned l = 0; l < ptr.size(); ++l)
-		      std::memset(ptr(l), i, ratio * sizeof(mln_value_(I)));
-		  }
-
+		  tmp[0] += 1;
+		  ptr(j) = & e_2(tmp);
 		}
-		else
+	      }
+
+	      for (unsigned j = 0; j < ncols; ++j)
+	      {
+		if (f.msk.element(p))
 		{
-		  // Propagation
-		  f.msk.element(p) = f.msk.element(f.parent.element(p));
 
-		  if (f.msk.element(p) && e_2(sq) == 0u)
+		  mln_site_(I) sq = site * ratio;
+
+		  if (f.parent.element(p) == p)
 		  {
-		    for (unsigned l = 0; l < ptr.size(); ++l)
-		      std::memset(ptr(l), i, ratio * sizeof(mln_value_(I)));
+		    // test over the component cardinality
+		    f.msk.element(p) = f.card.element(p) > lambda_min
+		      && f.card.element(p) < lambda_max;
+
+		    if (f.msk.element(p) && e_2(sq) == 0u)
+		    {
+		      for (unsigned l = 0; l < ptr.size(); ++l)
+			std::memset(ptr(l), i, ratio * sizeof(mln_value_(I)));
+		    }
+
 		  }
+		  else
+		  {
+		    // Propagation
+		    f.msk.element(p) = f.msk.element(f.parent.element(p));
 
+		    if (f.msk.element(p) && e_2(sq) == 0u)
+		    {
+		      for (unsigned l = 0; l < ptr.size(); ++l)
+			std::memset(ptr(l), i, ratio * sizeof(mln_value_(I)));
+		    }
+
+		  }
 		}
-	      }
 
-	      for (unsigned l = 0; l < ptr.size(); ++l)
-		ptr(l) -= ratio;
+		for (unsigned l = 0; l < ptr.size(); ++l)
+		  ptr(l) -= ratio;
 
-	      --site[1];
-	      --p;
-	    }
+		--site[1];
+		--p;
+	      }
 
-	  }
-	} // end of 2nd pass
+	    }
+	  } // end of 2nd pass
+	}
 
 
-#  ifdef SCRIBO_SAUVOLA_DEBUG
-	io::pbm::save(f.msk,
-		      scribo::make::debug_filename(internal::threshold_image_output).c_str());
-#  endif // ! SCRIBO_SAUVOLA_DEBUG
+	if (debug)
+	  debug->scale_objects[i] = f.msk;
 
 	return f.t_sub;
       }
 
 
 
-      template <typename I, typename J, typename K>
-      mln_ch_value(I, bool)
-      multi_scale_binarization(const I& in, const J& e2,
-			       const util::array<K>& t_ima,
-			       unsigned s)
+      /// Values compared by binarize_block. The comparison operators
+      /// of int_u8 are not inlined well enough to be unrolled or
+      /// vectorized, so 8-bit values are compared as unsigned char.
+      template <typename V>
+      inline
+      const V* block_values(const V* ptr)
       {
-	mln_ch_value(I,bool) out;
-	initialize(out, in);
+	return ptr;
+      }
 
+      inline
+      const unsigned char* block_values(const int_u8* ptr)
+      {
+	mln_precondition(sizeof(int_u8) == 1);
+	return reinterpret_cast<const unsigned char*>(ptr);
+      }
+
+      template <typename V>
+      inline
+      const V& block_value(const V& v)
+      {
+	return v;
+      }
+
+      inline
+      unsigned char block_value(const int_u8& v)
+      {
+	return v.to_enc();
+      }
+
+
+      /// Binarize the \p s x \p s block of pixels starting at \p in
+      /// with \p threshold, passed by value since \p out may alias
+      /// it.
+      template <unsigned s, typename V, typename T>
+      inline
+      void
+      binarize_block_(const V* in, bool* out, const T threshold,
+		      int stride)
+      {
+	for (unsigned i = 0; i < s; ++i, in += stride, out += stride)
+	  for (unsigned j = 0; j < s; ++j)
+	    out[j] = in[j] <= threshold;
+      }
+
+      template <typename V, typename T>
+      inline
+      void
+      binarize_block_(const V* in, bool* out, const T threshold,
+		      int stride, unsigned s)
+      {
+	for (unsigned i = 0; i < s; ++i, in += stride, out += stride)
+	  for (unsigned j = 0; j < s; ++j)
+	    out[j] = in[j] <= threshold;
+      }
+
+
+      /// Binarize blocks of s x s pixels with a single threshold.
+      /// The block size is a template parameter for the common scale
+      /// factors so that the loops are unrolled; binarize_block<0>
+      /// handles the other ones.
+      template <unsigned s>
+      struct binarize_block
+      {
+	binarize_block(unsigned, int stride)
+	  : stride_(stride)
+	{
+	}
+
+	/// Binarize the block whose top left pixel is \p ptr_in, then
+	/// move \p ptr_in and \p ptr_out by \p next from the bottom
+	/// right pixel of the block.
+	template <typename V, typename T>
+	void operator()(const V*& ptr_in, bool*& ptr_out,
+			const T& threshold, int next) const
+	{
+	  binarize_block_<s>(block_values(ptr_in), ptr_out,
+			     block_value(threshold), stride_);
+
+	  const int last = (s - 1) * stride_ + (s - 1) + next;
+	  ptr_in += last;
+	  ptr_out += last;
+	}
+
+	int stride_;
+      };
+
+
+      template <>
+      struct binarize_block<0>
+      {
+	binarize_block(unsigned s, int stride)
+	  : s_(s), stride_(stride)
+	{
+	}
+
+	template <typename V, typename T>
+	void operator()(const V*& ptr_in, bool*& ptr_out,
+			const T& threshold, int next) const
+	{
+	  binarize_block_(block_values(ptr_in), ptr_out,
+			  block_value(threshold), stride_, s_);
+
+	  const int last = (s_ - 1) * stride_ + (s_ - 1) + next;
+	  ptr_in += last;
+	  ptr_out += last;
+	}
+
+	unsigned s_;
+	int stride_;
+      };
+
+
+      /// Binarize the rows of \p in matching the rows
+      /// [\p row4_begin, \p row4_end[ of the image at scale 4, with
+      /// \p block binarizing each block of s x s pixels.
+      template <typename B, typename I, typename J, typename K>
+      void
+      multi_scale_binarization_rows(const B& block,
+				    const I& in, const J& e2,
+				    const util::array<K>& t_ima,
+				    unsigned s,
+				    int row4_begin, int row4_end,
+				    mln_ch_value(I, bool)& out)
+      {
 	typedef const mln_value(K)* ptr_type;
 
-	// Warning: if there are pixels with value different from 2, 3
-	// or 4 in e2, it will crash because of that array...
+	// e2 only holds the scales 2, 3 and 4, see has_scale().
 	ptr_type ptr_t[5];
-	ptr_t[2] = & t_ima[2].at_(0, 0);
-	ptr_t[3] = & t_ima[3].at_(0, 0);
-	ptr_t[4] = & t_ima[4].at_(0, 0);
+	ptr_t[2] = & t_ima[2].at_(4 * row4_begin, 0);
+	ptr_t[3] = & t_ima[3].at_(2 * row4_begin, 0);
+	ptr_t[4] = & t_ima[4].at_(row4_begin, 0);
 
 
-	const mln_value(J)* ptr_e2   = & e2.at_(0, 0);
-	const mln_value(I)* ptr__in = & in.at_(0, 0);
-	bool*    ptr__out = & out.at_(0, 0);
+	const mln_value(J)* ptr_e2   = & e2.at_(4 * row4_begin, 0);
+	const mln_value(I)* ptr__in = & in.at_(4 * s * row4_begin, 0);
+	bool*    ptr__out = & out.at_(4 * s * row4_begin, 0);
 
 
 	// Since we iterate from a smaller image in the largest ones and
@@ -303,10 +622,8 @@ namespace scribo
 	  more_offset = 0; // No offset needed.
 
 	const int
-	  nrows4 = t_ima[4].nrows(),
 	  ncols4 = t_ima[4].ncols(),
 
-	  delta1  = in.delta_index(dpoint2d(+1, -(s - 1))),
 	  delta1b = in.delta_index(dpoint2d(+1, -(s + s - 1))),
 	  delta1c = in.delta_index(dpoint2d(-(s + s - 1), +1)),
 	  delta1d = in.delta_index(dpoint2d(+1, -(s * 4 - 1))),
@@ -325,107 +642,26 @@ namespace scribo
 	  eor4 = t_ima[4].delta_index(dpoint2d(+1,- t_ima[4].ncols()));
 
 	mln_value(J) threshold;
-	for (int row4 = 0; row4 < nrows4; ++row4)
+	for (int row4 = row4_begin; row4 < row4_end; ++row4)
 	{
 	  for (int col4 = 0; col4 < ncols4; ++col4)
 	  {
 	    // top left  1
 	    {
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1f; ptr__in += delta1f;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1f);
 
 	      ++ptr_t[2]; ++ptr_e2;
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1b; ptr__in += delta1b;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1b);
 
 	      ptr_t[2] += delta2; ptr_e2 += delta2;
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1f; ptr__in += delta1f;
-
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1f);
 
 	      ++ptr_t[2]; ++ptr_e2;
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1c; ptr__in += delta1c;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1c);
 
 	      ptr_t[2] -= delta2; ptr_e2 -= delta2;
 	    }
@@ -434,99 +670,19 @@ namespace scribo
 	    ptr_t[3] += 1;
 	    {
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1f; ptr__in += delta1f;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1f);
 
 	      ++ptr_t[2]; ++ptr_e2;
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1b; ptr__in += delta1b;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1b);
 
 	      ptr_t[2] += delta2; ptr_e2 += delta2;
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1f; ptr__in += delta1f;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1f);
 
 	      ++ptr_t[2]; ++ptr_e2;
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1d; ptr__in += delta1d;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1d);
 
 	      ptr_t[2] += delta2b; ptr_e2 += delta2b;
 	    }
@@ -535,99 +691,19 @@ namespace scribo
 	    ptr_t[3] += delta3;
 	    {
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1f; ptr__in += delta1f;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1f);
 
 	      ++ptr_t[2]; ++ptr_e2;
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1b; ptr__in += delta1b;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1b);
 
 	      ptr_t[2] += delta2; ptr_e2 += delta2;
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1f; ptr__in += delta1f;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1f);
 
 	      ++ptr_t[2]; ++ptr_e2;
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1c; ptr__in += delta1c;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1c);
 
 	      ptr_t[2] -= delta2; ptr_e2 -= delta2;
 	    }
@@ -636,99 +712,19 @@ namespace scribo
 	    ptr_t[3] += 1;
 	    {
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1f; ptr__in += delta1f;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1f);
 
 	      ++ptr_t[2]; ++ptr_e2;
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1b; ptr__in += delta1b;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1b);
 
 	      ptr_t[2] += delta2; ptr_e2 += delta2;
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1f; ptr__in += delta1f;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1f);
 
 	      ++ptr_t[2]; ++ptr_e2;
 	      threshold = *ptr_t[*ptr_e2];
-	      {
-		for (unsigned i = 1; i < s; ++i)
-		{
-		  for (unsigned j = 1; j < s; ++j)
-		  {
-		    *ptr__out = *ptr__in <= threshold;
-		    ++ptr__out; ++ptr__in;
-		  }
-
-		  *ptr__out = *ptr__in <= threshold;
-		  ptr__out += delta1; ptr__in += delta1;
-		}
-
-		for (unsigned j = 1; j < s; ++j)
-		{
-		  *ptr__out = *ptr__in <= threshold;
-		  ++ptr__out; ++ptr__in;
-		}
-		*ptr__out = *ptr__in <= threshold;
-		ptr__out += delta1e; ptr__in += delta1e;
-	      }
+	      block(ptr__in, ptr__out, threshold, delta1e);
 	    }
 
 	    // bot right -> next top left
@@ -743,27 +739,156 @@ namespace scribo
 	  ptr_t[3] += eor3;
 	  ptr_t[4] += eor4;
 	}
+      }
+
+
+      /// Binarize the rows of \p in matching the rows
+      /// [\p row4_begin, \p row4_end[ of the image at scale 4.
+      template <typename I, typename J, typename K>
+      void
+      multi_scale_binarization_rows(const I& in, const J& e2,
+				    const util::array<K>& t_ima,
+				    unsigned s,
+				    int row4_begin, int row4_end,
+				    mln_ch_value(I, bool)& out)
+      {
+	const int stride = in.delta_index(dpoint2d(+1, 0));
+
+	switch (s)
+	{
+	  case 2:
+	    multi_scale_binarization_rows(binarize_block<2>(s, stride),
+					  in, e2, t_ima, s,
+					  row4_begin, row4_end, out);
+	    break;
+
+	  case 3:
+	    multi_scale_binarization_rows(binarize_block<3>(s, stride),
+					  in, e2, t_ima, s,
+					  row4_begin, row4_end, out);
+	    break;
+
+	  default:
+	    multi_scale_binarization_rows(binarize_block<0>(s, stride),
+					  in, e2, t_ima, s,
+					  row4_begin, row4_end, out);
+	}
+      }
+
+
+      template <typename I, typename J, typename K>
+      mln_ch_value(I, bool)
+      multi_scale_binarization(const I& in, const J& e2,
+			       const util::array<K>& t_ima,
+			       unsigned s, unsigned nthreads)
+      {
+	mln_ch_value(I,bool) out;
+	initialize(out, in);
+
+	const int nrows4 = t_ima[4].nrows();
+
+#  ifdef _OPENMP
+	if (nthreads > 1)
+	{
+	  // Bands of rows write disjoint parts of out.
+	  const int
+	    band = band_height(nrows4, nthreads),
+	    nbands = (nrows4 + band - 1) / band;
+
+#   pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+	  for (int b = 0; b < nbands; ++b)
+	    multi_scale_binarization_rows(in, e2, t_ima, s, b * band,
+					  std::min(nrows4, (b + 1) * band),
+					  out);
+
+	  return out;
+	}
+#  else
+	(void) nthreads;
+#  endif // ! _OPENMP
 
+	multi_scale_binarization_rows(in, e2, t_ima, s, 0, nrows4, out);
 	return out;
       }
 
 
 
+      /// Whether an image is large enough for the subscales of
+      /// sauvola_ms() with the scale factor \p s: the image at the
+      /// highest scale, 4 * \p s times smaller, must be at least 2
+      /// pixels high and wide.
+      inline
+      bool
+      has_subscales(unsigned nrows, unsigned ncols, unsigned s)
+      {
+	const unsigned block = 4 * s;
+	return nrows > block && ncols > block;
+      }
+
+
+      /// Whether a component was selected at some scale, i.e. \p e_2
+      /// is not only made of zeros.  Otherwise there is nothing to
+      /// propagate and the scale of the sites would be left to 0.
+      inline
+      bool
+      has_scale(const image2d<int_u8>& e_2)
+      {
+	const int nrows = e_2.nrows(), ncols = e_2.ncols();
+	for (int row = 0; row < nrows; ++row)
+	{
+	  const int_u8* ptr = & e_2.at_(row, 0);
+	  for (int col = 0; col < ncols; ++col)
+	    if (ptr[col] != 0u)
+	      return true;
+	}
+	return false;
+      }
+
+
       inline
       unsigned sub(unsigned nbr, unsigned down_scaling)
       {
 	return (nbr + down_scaling - 1) / down_scaling;
       }
 
+      /// Use the first subscale given to sauvola_ms(), if any and if
+      /// it matches the input image.
+      template <typename I>
+      inline
+      bool
+      reuse_first_scale(const sauvola_ms_first_scale*, unsigned,
+			const box2d&, util::array<I>&, integral_image&)
+      {
+	return false;
+      }
+
+      inline
+      bool
+      reuse_first_scale(const sauvola_ms_first_scale* first, unsigned s,
+			const box2d& domain,
+			util::array<image2d<int_u8> >& sub_ima,
+			integral_image& integral_sum_sum_2)
+      {
+	if (!first || first->s != s || !first->sub.is_valid()
+	    || first->sub.domain() != domain)
+	  return false;
+
+	sub_ima.append(first->sub);
+	integral_sum_sum_2 = first->integral;
+	return true;
+      }
+
+
       // Compute domains of subsampled images and make sure they can be
       // divided by 2.
-      template <typename I>
-      util::array<util::couple<mln_domain(I), unsigned> >
-      compute_sub_domains(const I& ima, unsigned n_scales, unsigned s)
+      inline
+      util::array<util::couple<box2d, unsigned> >
+      compute_sub_domains(unsigned nrows, unsigned ncols,
+			  unsigned n_scales, unsigned s)
       {
 	util::array<util::couple<unsigned, unsigned> > n(n_scales + 2);
 
-	n(1) = mln::make::couple(ima.nrows(), ima.ncols());
+	n(1) = mln::make::couple(nrows, ncols);
 	n(2) = mln::make::couple(sub(n(1).first(), s),
 				 sub(n(1).second(), s));
 	for (unsigned i = 3; i <= n_scales + 1; ++i)
@@ -771,10 +896,9 @@ namespace scribo
 				   sub(n(i - 1).second(), 2));
 
 
-	util::array<util::couple<mln_domain(I), unsigned> > out(n.size());
+	util::array<util::couple<box2d, unsigned> > out(n.size());
 	out(0) = mln::make::couple(mln::make::box2d(1,1), 1u);
-	out(1) = mln::make::couple(mln::make::box2d(ima.nrows(),
-						    ima.ncols()), 2u);
+	out(1) = mln::make::couple(mln::make::box2d(nrows, ncols), 2u);
 	out(n_scales + 1) = mln::make::couple(
 	  mln::make::box2d(n(n_scales + 1).first(),
 			   n(n_scales + 1).second()), 1u);
@@ -785,12 +909,19 @@ namespace scribo
 			     2 * out(i + 1).first().ncols()),
 	    2 * out(i + 1).second());
 
-	out(1).second() = std::max(out(2).first().ncols() * s - ima.ncols(),
-				   out(2).first().nrows() * s - ima.nrows());
+	out(1).second() = std::max(out(2).first().ncols() * s - ncols,
+				   out(2).first().nrows() * s - nrows);
 
 	return out;
       }
 
+      template <typename I>
+      util::array<util::couple<mln_domain(I), unsigned> >
+      compute_sub_domains(const I& ima, unsigned n_scales, unsigned s)
+      {
+	return compute_sub_domains(ima.nrows(), ima.ncols(), n_scales, s);
+      }
+
     } // end of namespace scribo::binarization::internal
 
 
@@ -806,7 +937,9 @@ namespace scribo
 	template <typename I>
 	mln_ch_value(I,bool)
 	sauvola_ms(const Image<I>& input_1_, unsigned w_1,
-		   unsigned s, double K)
+		   unsigned s, double K, unsigned nthreads,
+		   const sauvola_ms_first_scale* first,
+		   sauvola_debug_sink* debug)
 	{
 	  trace::entering("scribo::binarization::sauvola_ms");
 
@@ -832,6 +965,16 @@ namespace scribo
 	  unsigned lambda_min_2 = lambda_min_1 / s;
 	  unsigned lambda_max_2 = lambda_min_2 * q;
 
+	  // Smaller images are binarized at a single scale.
+	  if (!internal::has_subscales(input_1.nrows(), input_1.ncols(), s))
+	  {
+	    mln_ch_value(I,bool)
+	      output = scribo::binarization::sauvola(input_1, w_1, K, debug);
+
+	    trace::exiting("scribo::binarization::sauvola_ms");
+	    return output;
+	  }
+
 
 	  util::array<I> t_ima;
 
@@ -859,14 +1002,16 @@ namespace scribo
 
 
 	  // Resize input and compute integral images.
-	  typedef image2d<util::couple<double,double> > integral_t;
+	  typedef integral_image integral_t;
 	  integral_t integral_sum_sum_2;
 
 	  // Subsampling from scale 1 to 2.
-	  sub_ima.append(scribo::subsampling::integral(input_1, s,
-						       integral_sum_sum_2,
-						       sub_domains[2].first(),
-						       sub_domains[2].second()));
+	  if (!internal::reuse_first_scale(first, s, sub_domains[2].first(),
+					   sub_ima, integral_sum_sum_2))
+	    sub_ima.append(scribo::subsampling::integral(input_1, s,
+							 integral_sum_sum_2,
+							 sub_domains[2].first(),
+							 sub_domains[2].second()));
 
 	  // Subsampling to scale 3 and 4.
 	  //
@@ -883,6 +1028,9 @@ namespace scribo
 	  initialize(e_2, sub_ima[2]);
 	  data::fill(e_2, 0u);
 
+	  if (debug)
+	    debug->scale_objects.resize(nb_subscale + 2);
+
 	  // Highest scale -> no maximum component size.
 	  {
 	    int i = sub_ima.size() - 1;
@@ -894,7 +1042,7 @@ namespace scribo
 						     s,
 						     q, i, w_work,
 						     integral_sum_sum_2,
-						     K);
+						     K, nthreads, debug);
 	  }
 
 	  // Other scales -> maximum and minimum component size.
@@ -909,7 +1057,7 @@ namespace scribo
 						       s,
 						       q, i, w_work,
 						       integral_sum_sum_2,
-						       K);
+						       K, nthreads, debug);
 	    }
 	  }
 
@@ -919,26 +1067,25 @@ namespace scribo
 						     lambda_max_2,
 						     s, 1, 2, w_work,
 						     integral_sum_sum_2,
-						     K);
+						     K, nthreads, debug);
 	  }
 
 
-#  ifdef SCRIBO_SAUVOLA_DEBUG
-	  if (internal::scale_image_output)
-	    io::pgm::save(e_2, internal::scale_image_output);
-#  endif // ! SCRIBO_SAUVOLA_DEBUG
-
-	  // Propagate scale values.
-	  e_2 = transform::influence_zone_geodesic(e_2, c8());
+	  if (debug)
+	    debug->scale = e_2;
 
-// #  ifdef SCRIBO_SAUVOLA_DEBUG
-// 	  if (internal::scale_image_output)
-// 	    io::pgm::save(e_2, internal::scale_image_output);
-// #  endif // ! SCRIBO_SAUVOLA_DEBUG
+	  // Propagate scale values.  On small or uniform images, no
+	  // component may have been selected at any scale: the lowest
+	  // one is used everywhere.
+	  if (internal::has_scale(e_2))
+	    e_2 = transform::influence_zone_geodesic(e_2, c8());
+	  else
+	    data::fill(e_2, 2u);
 
 	  // Binarize
 	  image2d<bool>
-	    output = internal::multi_scale_binarization(input_1, e_2, t_ima, s);
+	    output = internal::multi_scale_binarization(input_1, e_2, t_ima, s,
+							nthreads);
 
 	  trace::exiting("scribo::binarization::sauvola_ms");
 	  return output;
@@ -955,7 +1102,110 @@ namespace scribo
     template <typename I>
     mln_ch_value(I,bool)
     sauvola_ms(const Image<I>& input_1_, unsigned w_1,
-	       unsigned s, double K)
+	       unsigned s, double K, unsigned nthreads)
+    {
+      return sauvola_ms(input_1_, w_1, s, K, nthreads, 0);
+    }
+
+
+    inline
+    image2d<bool>
+    sauvola_ms(const image2d<int_u8>& input_1, unsigned w_1, unsigned s,
+	       double K, unsigned nthreads,
+	       const sauvola_ms_first_scale& first)
+    {
+      trace::entering("scribo::binarization::sauvola_ms");
+
+      mln_precondition(input_1.is_valid());
+
+      image2d<bool>
+	output = impl::generic::sauvola_ms(input_1, w_1, s, K,
+					   nthreads, &first, 0);
+
+      trace::exiting("scribo::binarization::sauvola_ms");
+      return output;
+    }
+
+
+    template <typename S>
+    image2d<int_u8>
+    sauvola_ms_read(S& source, unsigned nrows, unsigned ncols, unsigned s,
+		    sauvola_ms_first_scale& first)
+    {
+      trace::entering("scribo::binarization::sauvola_ms_read");
+
+      mln_precondition(s == 2 || s == 3);
+
+      first = sauvola_ms_first_scale();
+
+      // sauvola_ms() does not use any subscale for small images.
+      if (!internal::has_subscales(nrows, ncols, s))
+      {
+	image2d<int_u8> output(mln::make::box2d(nrows, ncols));
+	for (unsigned row = 0; row < nrows; ++row)
+	  source.read_row(& output.at_(row, 0));
+
+	trace::exiting("scribo::binarization::sauvola_ms_read");
+	return output;
+      }
+
+      // Same number of subscales as sauvola_ms().
+      util::array<util::couple<box2d, unsigned> >
+	sub_domains = internal::compute_sub_domains(nrows, ncols, 3, s);
+
+      // The first subscale overlaps the right and bottom borders,
+      // mirrored as sauvola_ms() does.
+      image2d<int_u8> output(mln::make::box2d(nrows, ncols),
+			     std::max(sub_domains(1).second(),
+				      unsigned(mln::border::thickness)));
+      const unsigned
+	right = sub_domains(2).first().ncols() * s - ncols,
+	sub_nrows = sub_domains(2).first().nrows();
+
+      first.s = s;
+      first.sub = image2d<int_u8>(sub_domains(2).first(),
+				  sub_domains(2).second());
+      extension::fill(first.sub, 0);
+      first.integral.init_(sub_domains(2).first(), sub_domains(2).second());
+
+      const int_u8* rows[3];
+      unsigned sub_row = 0;
+      for (unsigned row = 0; row < nrows; ++row)
+      {
+	int_u8* p = & output.at_(row, 0);
+	source.read_row(p);
+	for (unsigned j = 1; j <= right; ++j)
+	  p[ncols - 1 + j] = p[ncols - j];
+
+	if ((row + 1) % s == 0)
+	{
+	  for (unsigned i = 0; i < s; ++i)
+	    rows[i] = & output.at_(row + 1 - s + i, 0);
+	  subsampling::impl::integral_row(rows, s, sub_row++,
+					  first.sub, first.integral);
+	}
+      }
+
+      // Remaining rows, overlapping the bottom border.
+      border::mirror(output);
+      for (; sub_row < sub_nrows; ++sub_row)
+      {
+	for (unsigned i = 0; i < s; ++i)
+	  rows[i] = & output.at_(s * sub_row + i, 0);
+	subsampling::impl::integral_row(rows, s, sub_row,
+					first.sub, first.integral);
+      }
+
+      trace::exiting("scribo::binarization::sauvola_ms_read");
+      return output;
+    }
+
+
+    template <typename I>
+    mln_ch_value(I,bool)
+    sauvola_ms(const Image<I>& input_1_, unsigned w_1,
+	       unsigned s, double K, unsigned nthreads,
+	       sauvola_debug_sink* debug)
     {
       trace::entering("scribo::binarization::sauvola_ms");
 
@@ -965,13 +1215,23 @@ namespace scribo
       mlc_is_not(mln_value(I), bool)::check();
 
       mln_ch_value(I,bool)
-	output = impl::generic::sauvola_ms(exact(input_1_), w_1, s, K);
+	output = impl::generic::sauvola_ms(exact(input_1_), w_1, s, K,
+					   nthreads, 0, debug);
 
       trace::exiting("scribo::binarization::sauvola_ms");
       return output;
     }
 
 
+    template <typename I>
+    mln_ch_value(I,bool)
+    sauvola_ms(const Image<I>& input_1_, unsigned w_1,
+	       unsigned s, double K)
+    {
+      return sauvola_ms(input_1_, w_1, s, K, 1);
+    }
+
+
     template <typename I>
     mln_ch_value(I,bool)
     sauvola_ms(const Image<I>& input_1, unsigned w_1, unsigned s)
@@ -108,9 +108,9 @@ namespace scribo
 
       bin_t r_b, g_b, b_b;
 
-      r_b = impl::generic::sauvola_ms(r_i, w_1, s, K);
-      g_b = impl::generic::sauvola_ms(g_i, w_1, s, K);
-      b_b = impl::generic::sauvola_ms(b_i, w_1, s, K);
+      r_b = impl::generic::sauvola_ms(r_i, w_1, s, K, 1, 0, 0);
+      g_b = impl::generic::sauvola_ms(g_i, w_1, s, K, 1, 0, 0);
+      b_b = impl::generic::sauvola_ms(b_i, w_1, s, K, 1, 0, 0);
 
       border::resize(r_b, input_1.border());
       border::resize(g_b, input_1.border());
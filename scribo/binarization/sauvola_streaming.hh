@@ -0,0 +1,351 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+#ifndef SCRIBO_BINARIZATION_SAUVOLA_STREAMING_HH
+# define SCRIBO_BINARIZATION_SAUVOLA_STREAMING_HH
+
+/// \file
+///
+/// \brief Binarize an image row by row with Sauvola's algorithm,
+/// without loading it in memory.
+
+# include <algorithm>
+# include <fstream>
+# include <string>
+# include <vector>
+
+# include <mln/value/int_u8.hh>
+# include <mln/io/pnm/load_header.hh>
+
+# include <scribo/core/integral_image.hh>
+# include <scribo/binarization/internal/compute_sauvola_threshold.hh>
+
+
+namespace scribo
+{
+
+  namespace binarization
+  {
+
+    using namespace mln;
+
+
+    /*! \brief Binarize an image read row by row, using Sauvola's
+        algorithm.
+
+      \param[in,out] source A functor providing the rows of the input
+                            image, in order, through
+                            source.read_row(value::int_u8* row).
+      \param[in,out] sink   A functor receiving the rows of the
+                            output image, in order, through
+                            sink.write_row(const bool* row).
+      \param[in] nrows       The number of rows of the image.
+      \param[in] ncols       The number of columns of the image.
+      \param[in] window_size The window size.
+      \param[in] K           Sauvola's formulae constant.
+
+      A row is written as soon as the rows of its window have been
+      read. Only the rows of one window, and sums over its columns,
+      are kept in memory, whatever the size of the image.
+
+      The output is the same as the one of
+      scribo::binarization::sauvola().
+     */
+    template <typename S, typename O>
+    void
+    sauvola_streaming(S& source, O& sink,
+		      unsigned nrows, unsigned ncols,
+		      unsigned window_size, double K);
+
+    /// \overload
+    /// K is set to 0.34.
+    //
+    template <typename S, typename O>
+    void
+    sauvola_streaming(S& source, O& sink,
+		      unsigned nrows, unsigned ncols,
+		      unsigned window_size);
+
+
+    /*! \brief Binarize a raw PGM file into a raw PBM file, using
+        Sauvola's algorithm.
+
+      Both files are processed row by row, see sauvola_streaming().
+     */
+    void
+    sauvola_streaming(const std::string& input_filename,
+		      const std::string& output_filename,
+		      unsigned window_size, double K);
+
+    /// \overload
+    /// K is set to 0.34.
+    //
+    void
+    sauvola_streaming(const std::string& input_filename,
+		      const std::string& output_filename,
+		      unsigned window_size);
+
+
+
+# ifndef MLN_INCLUDE_ONLY
+
+
+    namespace internal
+    {
+
+      /// Read the rows of a raw 8-bit PGM stream.
+      struct pgm_row_reader
+      {
+	pgm_row_reader(std::istream& istr, unsigned ncols)
+	  : istr_(istr), ncols_(ncols)
+	{
+	}
+
+	void read_row(value::int_u8* row)
+	{
+	  istr_.read((char*) row, ncols_);
+	}
+
+	std::istream& istr_;
+	unsigned ncols_;
+      };
+
+
+      /// Write the rows of a raw PBM stream.
+      struct pbm_row_writer
+      {
+	pbm_row_writer(std::ostream& ostr, unsigned ncols)
+	  : ostr_(ostr), ncols_(ncols), buffer_((ncols + 7) / 8)
+	{
+	}
+
+	void write_row(const bool* row)
+	{
+	  std::fill(buffer_.begin(), buffer_.end(), 0);
+	  for (unsigned col = 0; col < ncols_; ++col)
+	    if (row[col] == false)
+	      buffer_[col / 8] |= 0x80 >> (col % 8); // As io::pbm::save.
+	  ostr_.write((const char*) &buffer_[0], buffer_.size());
+	}
+
+	std::ostream& ostr_;
+	unsigned ncols_;
+	std::vector<unsigned char> buffer_;
+      };
+
+    } // end of namespace scribo::binarization::internal
+
+
+
+    template <typename S, typename O>
+    void
+    sauvola_streaming(S& source, O& sink,
+		      unsigned nrows, unsigned ncols,
+		      unsigned window_size, double K)
+    {
+      trace::entering("scribo::binarization::sauvola_streaming");
+
+      mln_precondition(nrows > 0 && ncols > 0);
+
+      typedef integral_image::sum_t Sum;
+      typedef integral_image::sum_2_t Sum2;
+
+      const int
+	w_2 = window_size >> 1,
+	nr = nrows,
+	nc = ncols;
+
+      // The windows are the ones of compute_sauvola_threshold: the
+      // sums over ]row_min, row_max] x ]col_min, col_max].
+
+      // Rows of the current window and the row leaving it.
+      const int nbuf = std::min(nr, 2 * w_2 + 2);
+      std::vector<value::int_u8> rows(nbuf * nc);
+      int nread = 0;
+
+      // Sums over the rows ]lo, hi] of each column.
+      std::vector<Sum> col_sum(nc, 0);
+      std::vector<Sum2> col_sum_2(nc, 0);
+      int lo = 0, hi = 0;
+
+      std::vector<Sum> prefix(nc);
+      std::vector<Sum2> prefix_2(nc);
+      std::vector<double> sum(nc), sum_2(nc);
+      std::vector<value::int_u8> t(nc);
+      bool* out = new bool[nc];
+
+      for (int row = 0; row < nr; ++row)
+      {
+	const int
+	  row_min = std::max(0, row - w_2 - 1),
+	  row_max = std::min(nr - 1, row + w_2);
+
+	// Slide the window down.
+	for (; hi < row_max; ++hi)
+	{
+	  for (; nread <= hi + 1; ++nread)
+	    source.read_row(&rows[(nread % nbuf) * nc]);
+
+	  const value::int_u8* v = &rows[((hi + 1) % nbuf) * nc];
+	  for (int col = 0; col < nc; ++col)
+	  {
+	    const unsigned x = v[col];
+	    col_sum[col] += x;
+	    col_sum_2[col] += x * x;
+	  }
+	}
+	for (; lo < row_min; ++lo)
+	{
+	  const value::int_u8* v = &rows[((lo + 1) % nbuf) * nc];
+	  for (int col = 0; col < nc; ++col)
+	  {
+	    const unsigned x = v[col];
+	    col_sum[col] -= x;
+	    col_sum_2[col] -= x * x;
+	  }
+	}
+	for (; nread <= row; ++nread)
+	  source.read_row(&rows[(nread % nbuf) * nc]);
+
+	// Window sums.
+	Sum s = 0;
+	Sum2 s_2 = 0;
+	for (int col = 0; col < nc; ++col)
+	{
+	  prefix[col] = s += col_sum[col];
+	  prefix_2[col] = s_2 += col_sum_2[col];
+	}
+	for (int col = 0; col < nc; ++col)
+	{
+	  const int
+	    col_min = std::max(0, col - w_2 - 1),
+	    col_max = std::min(nc - 1, col + w_2);
+	  sum[col] = Sum(prefix[col_max] - prefix[col_min]);
+	  sum_2[col] = Sum2(prefix_2[col_max] - prefix_2[col_min]);
+	}
+
+	// Thresholds, by runs of windows of the same area.
+	for (int col = 0; col < nc; )
+	{
+	  const int width = std::min(nc - 1, col + w_2)
+	    - std::max(0, col - w_2 - 1);
+	  int end = col + 1;
+	  while (end < nc && std::min(nc - 1, end + w_2)
+		 - std::max(0, end - w_2 - 1) == width)
+	    ++end;
+
+	  internal::sauvola_threshold_row(&sum[col], &sum_2[col], end - col,
+					  double((row_max - row_min) * width),
+					  K, SCRIBO_DEFAULT_SAUVOLA_R, &t[col]);
+	  col = end;
+	}
+
+	// Binarize, as local_threshold does.
+	const value::int_u8* v = &rows[(row % nbuf) * nc];
+	for (int col = 0; col < nc; ++col)
+	  out[col] = v[col] <= t[col];
+
+	sink.write_row(out);
+      }
+
+      delete[] out;
+
+      trace::exiting("scribo::binarization::sauvola_streaming");
+    }
+
+
+    template <typename S, typename O>
+    void
+    sauvola_streaming(S& source, O& sink,
+		      unsigned nrows, unsigned ncols,
+		      unsigned window_size)
+    {
+      sauvola_streaming(source, sink, nrows, ncols, window_size,
+			SCRIBO_DEFAULT_SAUVOLA_K);
+    }
+
+
+    inline
+    void
+    sauvola_streaming(const std::string& input_filename,
+		      const std::string& output_filename,
+		      unsigned window_size, double K)
+    {
+      trace::entering("scribo::binarization::sauvola_streaming");
+
+      std::ifstream istr(input_filename.c_str(), std::ios::binary);
+      if (! istr)
+      {
+	std::cerr << "error: cannot open file '" << input_filename << "'!";
+	abort();
+      }
+
+      char type;
+      int nrows, ncols;
+      unsigned maxval;
+      io::pnm::read_header('2', '5', istr, type, nrows, ncols, maxval);
+      if (type != '5' || maxval > 255)
+      {
+	std::cerr << "error: '" << input_filename
+		  << "' is not a raw 8-bit PGM file!";
+	abort();
+      }
+
+      std::ofstream ostr(output_filename.c_str(), std::ios::binary);
+      if (! ostr)
+      {
+	std::cerr << "error: cannot open file '" << output_filename << "'!";
+	abort();
+      }
+      ostr << "P4" << std::endl
+	   << ncols << ' ' << nrows << std::endl;
+
+      internal::pgm_row_reader source(istr, ncols);
+      internal::pbm_row_writer sink(ostr, ncols);
+      sauvola_streaming(source, sink, nrows, ncols, window_size, K);
+
+      trace::exiting("scribo::binarization::sauvola_streaming");
+    }
+
+
+    inline
+    void
+    sauvola_streaming(const std::string& input_filename,
+		      const std::string& output_filename,
+		      unsigned window_size)
+    {
+      sauvola_streaming(input_filename, output_filename, window_size,
+			SCRIBO_DEFAULT_SAUVOLA_K);
+    }
+
+
+# endif // ! MLN_INCLUDE_ONLY
+
+  } // end of namespace scribo::binarization
+
+} // end of namespace scribo
+
+
+#endif // ! SCRIBO_BINARIZATION_SAUVOLA_STREAMING_HH
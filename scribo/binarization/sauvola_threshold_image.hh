@@ -61,15 +61,29 @@ namespace scribo
       \input[out] squared     The sum of all squared intensities of \p
                               input.
 
+      \p simple and \p squared may be double or unsigned integer
+      integral images, see scribo::integral_image.
+
       \return An image of local thresholds.
 
      */
-    template <typename I, typename J>
+    template <typename I, typename J, typename J2>
+    mln_ch_value(I, value::int_u8)
+    sauvola_threshold_image(const Image<I>& input, unsigned window_size,
+			    double K,
+			    Image<J>& simple,
+			    Image<J2>& squared);
+
+    /// \overload
+    /// The local statistics are recorded in \p debug, if not null.
+    //
+    template <typename I, typename J, typename J2>
     mln_ch_value(I, value::int_u8)
     sauvola_threshold_image(const Image<I>& input, unsigned window_size,
 			    double K,
 			    Image<J>& simple,
-			    Image<J>& squared);
+			    Image<J2>& squared,
+			    sauvola_debug_sink* debug);
 
     /// \overload
     template <typename I>
@@ -77,6 +91,14 @@ namespace scribo
     sauvola_threshold_image(const Image<I>& input, unsigned window_size,
 			    double K);
 
+    /// \overload
+    /// The local statistics are recorded in \p debug, if not null.
+    //
+    template <typename I>
+    mln_ch_value(I, value::int_u8)
+    sauvola_threshold_image(const Image<I>& input, unsigned window_size,
+			    double K, sauvola_debug_sink* debug);
+
     /// \overload
     /// K is set to 0.34
     template <typename I>
@@ -105,19 +127,20 @@ namespace scribo
       namespace generic
       {
 
-	template <typename I, typename J>
+	template <typename I, typename J, typename J2>
 	inline
 	mln_concrete(I)
 	sauvola_threshold_image(const Image<I>& input_, unsigned window_size,
 				double K,
 				Image<J>& simple_,
-				Image<J>& squared_)
+				Image<J2>& squared_,
+				sauvola_debug_sink* debug)
 	{
 	  trace::entering("scribo::binarization::impl::generic::sauvola_threshold_image");
 
 	  const I& input = exact(input_);
 	  J& simple = exact(simple_);
-	  J& squared = exact(squared_);
+	  J2& squared = exact(squared_);
 
 	  mln_assertion(input.is_valid());
 	  mln_assertion(simple.is_valid());
@@ -126,13 +149,8 @@ namespace scribo
 	  typedef mln_value(I) V;
 	  typedef mln_site(I) P;
 
-#  ifdef SCRIBO_SAUVOLA_DEBUG
-	  initialize(internal::debug_mean, input);
-	  initialize(internal::debug_stddev, input);
-	  initialize(internal::debug_threshold, input);
-	  initialize(internal::debug_alpham, input);
-	  initialize(internal::debug_alphacond, input);
-#  endif // ! SCRIBO_SAUVOLA_DEBUG
+	  if (debug)
+	    debug->init_stats(input);
 
 	  // Sauvola Algorithm with I.I.
 
@@ -146,24 +164,13 @@ namespace scribo
 
 	  for(mln::def::coord row = 0; row < nrows; ++row)
 	    for(mln::def::coord col = 0; col < ncols; ++col)
-	    {
-#  ifdef SCRIBO_SAUVOLA_DEBUG
-
-	      double t = internal::compute_sauvola_threshold(P(row, col), simple,
-							     squared, window_size,
-							     K,
-							     SCRIBO_DEFAULT_SAUVOLA_R);
-	      mln::convert::from_to(t, output.at_(row, col));
-	      internal::debug_threshold.at_(row, col) = t;
-#  else
 	      mln::convert::from_to(
 		internal::compute_sauvola_threshold(P(row, col), simple,
 						    squared, window_size,
 						    K,
-						    SCRIBO_DEFAULT_SAUVOLA_R),
+						    SCRIBO_DEFAULT_SAUVOLA_R,
+						    debug),
 		output.at_(row, col));
-#  endif // ! SCRIBO_SAUVOLA_DEBUG
-	    }
 
 	  trace::exiting("scribo::binarization::impl::generic::sauvola_threshold");
 	  return output;
@@ -173,16 +180,131 @@ namespace scribo
 
 
 
-      template <typename I, typename J>
+      /// Rows are processed with sauvola_threshold_row except near
+      /// the image borders, where the window is clamped.
+      template <typename S, typename S2>
+      inline
+      image2d<value::int_u8>
+      sauvola_threshold_image_fastest(const image2d<value::int_u8>& input,
+				      unsigned window_size,
+				      double K,
+				      const image2d<S>& simple,
+				      const image2d<S2>& squared)
+      {
+	trace::entering("scribo::binarization::impl::sauvola_threshold_image_fastest");
+
+	mln_assertion(input.is_valid());
+	mln_assertion(simple.is_valid());
+	mln_assertion(squared.is_valid());
+
+	typedef point2d P;
+
+	image2d<value::int_u8> output;
+	initialize(output, input);
+
+	const int
+	  nrows = input.nrows(),
+	  ncols = input.ncols(),
+	  w_2 = window_size >> 1,
+	  // Columns and rows whose window is not clamped.
+	  col_begin = w_2 + 1,
+	  col_end = ncols - w_2,
+	  row_begin = w_2 + 1,
+	  row_end = nrows - w_2;
+
+	const double wh = (2 * w_2 + 1) * (2 * w_2 + 1);
+
+	enum { chunk = 256 };
+	double sum[chunk], sum_2[chunk];
+
+	for (int row = 0; row < nrows; ++row)
+	{
+	  int col = 0;
+
+	  if (row >= row_begin && row < row_end)
+	  {
+	    for (; col < col_begin && col < ncols; ++col)
+	      mln::convert::from_to(
+		internal::compute_sauvola_threshold(P(row, col), simple,
+						    squared, window_size,
+						    K,
+						    SCRIBO_DEFAULT_SAUVOLA_R),
+		output.at_(row, col));
+
+	    // Window corners, as in compute_sauvola_threshold.
+	    const S
+	      *s_min = &simple.at_(row - w_2 - 1, 0),
+	      *s_max = &simple.at_(row + w_2, 0);
+	    const S2
+	      *q_min = &squared.at_(row - w_2 - 1, 0),
+	      *q_max = &squared.at_(row + w_2, 0);
+
+	    while (col < col_end)
+	    {
+	      const int n = std::min(int(chunk), col_end - col);
+	      for (int i = 0; i < n; ++i)
+	      {
+		const int
+		  c_min = col + i - w_2 - 1,
+		  c_max = col + i + w_2;
+		// Computed with S and S2, which may wrap around.
+		sum[i] = S(s_max[c_max] + s_min[c_min] - s_max[c_min] - s_min[c_max]);
+		sum_2[i] = S2(q_max[c_max] + q_min[c_min] - q_max[c_min] - q_min[c_max]);
+	      }
+
+	      internal::sauvola_threshold_row(sum, sum_2, n, wh, K,
+					      SCRIBO_DEFAULT_SAUVOLA_R,
+					      &output.at_(row, col));
+	      col += n;
+	    }
+	  }
+
+	  for (; col < ncols; ++col)
+	    mln::convert::from_to(
+	      internal::compute_sauvola_threshold(P(row, col), simple,
+						  squared, window_size,
+						  K,
+						  SCRIBO_DEFAULT_SAUVOLA_R),
+	      output.at_(row, col));
+	}
+
+	trace::exiting("scribo::binarization::impl::sauvola_threshold_image_fastest");
+	return output;
+      }
+
+
+
+      template <typename I, typename J, typename J2>
       inline
       mln_concrete(I)
       sauvola_threshold_image_gl(const I& input, unsigned window_size,
 				 double K,
 				 Image<J>& simple,
-				 Image<J>& squared)
+				 Image<J2>& squared,
+				 sauvola_debug_sink* debug)
       {
 	return impl::generic::sauvola_threshold_image(input, window_size, K,
-						      simple, squared);
+						      simple, squared, debug);
+      }
+
+      template <typename S, typename S2>
+      inline
+      image2d<value::int_u8>
+      sauvola_threshold_image_gl(const image2d<value::int_u8>& input,
+				 unsigned window_size,
+				 double K,
+				 Image< image2d<S> >& simple,
+				 Image< image2d<S2> >& squared,
+				 sauvola_debug_sink* debug)
+      {
+	// The fast version does not compute the local statistics.
+	if (debug)
+	  return impl::generic::sauvola_threshold_image(input, window_size, K,
+							simple, squared, debug);
+
+	return impl::sauvola_threshold_image_fastest(input, window_size, K,
+						     exact(simple),
+						     exact(squared));
       }
 
 
@@ -196,28 +318,30 @@ namespace scribo
     namespace internal
     {
 
-      template <unsigned n, typename I, typename J>
+      template <unsigned n, typename I, typename J, typename J2>
       inline
       mln_ch_value(I, value::int_u<n>)
       sauvola_threshold_image_dispatch(const value::int_u<n>&, const I& input,
 				       unsigned window_size,
 				       double K,
 				       J& simple,
-				       J& squared)
+				       J2& squared,
+				       sauvola_debug_sink* debug)
       {
 	return impl::sauvola_threshold_image_gl(input, window_size, K,
-						simple, squared);
+						simple, squared, debug);
       }
 
 
-      template <typename I, typename J>
+      template <typename I, typename J, typename J2>
       inline
       mln_ch_value(I, value::int_u8)
       sauvola_threshold_image_dispatch(const mln_value(I)&, const I& input,
 				       unsigned window_size,
 				       double K,
 				       J& simple,
-				       J& squared)
+				       J2& squared,
+				       sauvola_debug_sink*)
       {
 	// No dispatch for this kind of value type.
 	mlc_abort(I)::check();
@@ -227,16 +351,60 @@ namespace scribo
       }
 
 
+
+      /// Compute the integral images and the thresholds.
+      template <typename I>
+      inline
+      mln_ch_value(I, value::int_u8)
+      sauvola_threshold_image_integral(const I& input, unsigned window_size,
+				       double K, sauvola_debug_sink* debug)
+      {
+	mln_ch_value(I, double)
+	  simple = init_integral_image(input, scribo::internal::identity_),
+	  squared = init_integral_image(input, scribo::internal::square_);
+
+	return sauvola_threshold_image(input, window_size,
+				       K, simple, squared, debug);
+      }
+
+      /// \overload
+      /// 8-bit images use integer integral images.
+      inline
+      image2d<value::int_u8>
+      sauvola_threshold_image_integral(const image2d<value::int_u8>& input,
+				       unsigned window_size, double K,
+				       sauvola_debug_sink* debug)
+      {
+	integral_image integral;
+	init_integral_image(input, integral);
+
+	return sauvola_threshold_image(input, window_size,
+				       K, integral.sum, integral.sum_2, debug);
+      }
+
     } // end of namespace scribo::binarization::internal
 
 
 
-    template <typename I, typename J>
+    template <typename I, typename J, typename J2>
     mln_ch_value(I, value::int_u8)
     sauvola_threshold_image(const Image<I>& input, unsigned window_size,
 			    double K,
 			    Image<J>& simple,
-			    Image<J>& squared)
+			    Image<J2>& squared)
+    {
+      return sauvola_threshold_image(input, window_size, K, simple, squared,
+				     0);
+    }
+
+
+    template <typename I, typename J, typename J2>
+    mln_ch_value(I, value::int_u8)
+    sauvola_threshold_image(const Image<I>& input, unsigned window_size,
+			    double K,
+			    Image<J>& simple,
+			    Image<J2>& squared,
+			    sauvola_debug_sink* debug)
     {
       trace::entering("scribo::binarization::sauvola_threshold_image");
 
@@ -250,7 +418,8 @@ namespace scribo
 							    window_size,
 							    K,
 							    exact(simple),
-							    exact(squared));
+							    exact(squared),
+							    debug);
 
       trace::exiting("scribo::text::ppm2pbm");
       return output;
@@ -263,12 +432,18 @@ namespace scribo
     sauvola_threshold_image(const Image<I>& input, unsigned window_size,
 			    double K)
     {
-      mln_ch_value(I, double)
-	simple = init_integral_image(input, scribo::internal::identity_),
-	squared = init_integral_image(input, scribo::internal::square_);
+      return sauvola_threshold_image(input, window_size, K, 0);
+    }
 
-      return sauvola_threshold_image(input, window_size,
-				     K, simple, squared);
+
+    template <typename I>
+    inline
+    mln_ch_value(I, value::int_u8)
+    sauvola_threshold_image(const Image<I>& input, unsigned window_size,
+			    double K, sauvola_debug_sink* debug)
+    {
+      return internal::sauvola_threshold_image_integral(exact(input),
+							window_size, K, debug);
     }
 
 
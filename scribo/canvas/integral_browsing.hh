@@ -31,6 +31,8 @@
 # include <mln/core/image/image2d.hh>
 # include <mln/util/couple.hh>
 
+# include <scribo/core/integral_image.hh>
+
 namespace scribo
 {
 
@@ -39,10 +41,37 @@ namespace scribo
     using namespace mln;
 
 
-    template <typename F>
-    void integral_browsing(const image2d<util::couple<double, double> >& ima,
+    /// Browse \p ima and call \p functor with the statistics of
+    /// the window around each site, in raster order.
+    ///
+    /// The functor is called with exec(mean, stddev) near the image
+    /// borders and with exec_row(sum, sum_2, n, area) for runs of
+    /// \p n consecutive sites of the image center, given the sums
+    /// of the values and of the squared values in their windows of
+    /// \p area pixels.
+    ///
+    /// \p ima is either an image of couples (sum, squared sum) or a
+    /// scribo::integral_image.
+    //
+    template <typename J, typename F>
+    void integral_browsing(const J& ima,
+			   unsigned step,
+			   unsigned w, unsigned h,
+			   unsigned s,
+			   F& functor);
+
+    /// \overload
+    ///
+    /// Only the rows of sites [\p row_begin, \p row_end[ are
+    /// browsed, rows being counted in the browsed sites. Distinct
+    /// rows can be browsed concurrently with distinct functors.
+    //
+    template <typename J, typename F>
+    void integral_browsing(const J& ima,
 			   unsigned step,
 			   unsigned w, unsigned h,
+			   unsigned s,
+			   unsigned row_begin, unsigned row_end,
 			   F& functor);
 
 
@@ -69,20 +98,71 @@ namespace scribo
 
       }
 
+
+      /// Access to the integral images browsed by integral_browsing.
+      template <typename J>
+      struct integral_browsing_traits;
+
+      template <>
+      struct integral_browsing_traits< image2d<util::couple<double, double> > >
+      {
+	typedef image2d<util::couple<double, double> > image_t;
+	typedef const util::couple<double, double>* ptr_t;
+	typedef double sum_t;
+	typedef double sum_2_t;
+
+	static ptr_t at(const image_t& ima,
+			mln::def::coord row, mln::def::coord col)
+	{
+	  return & ima.at_(row, col);
+	}
+      };
+
+      template <>
+      struct integral_browsing_traits<integral_image>
+      {
+	typedef integral_image image_t;
+	typedef integral_image::cursor ptr_t;
+
+	// Differences of corners wrap around like the stored sums.
+	typedef integral_image::sum_t sum_t;
+	typedef integral_image::sum_2_t sum_2_t;
+
+	static ptr_t at(const image_t& ima,
+			mln::def::coord row, mln::def::coord col)
+	{
+	  return ima.ptr(row, col);
+	}
+      };
+
     } // end of namespace scribo::canvas::internal
 
 
 
 
-    template <typename F>
-    void integral_browsing(const image2d<util::couple<double, double> >& ima,
+    template <typename J, typename F>
+    void integral_browsing(const J& ima,
+			   unsigned step,
+			   unsigned w, unsigned h,
+			   unsigned s,
+			   F& functor)
+    {
+      integral_browsing(ima, step, w, h, s, 0, mln_max(unsigned), functor);
+    }
+
+
+    template <typename J, typename F>
+    void integral_browsing(const J& ima,
 			   unsigned step,
 			   unsigned w, unsigned h,
 			   unsigned s,
+			   unsigned row_begin, unsigned row_end,
 			   F& functor)
     {
-      typedef util::couple<double, double> V;
-      typedef const V* Ptr;
+      typedef internal::integral_browsing_traits<J> traits;
+      typedef typename traits::ptr_t Ptr;
+      typedef typename traits::sum_t S;
+      typedef typename traits::sum_2_t S2;
       Ptr a_ima, b_ima, c_ima, d_ima;
 
 //       mln_precondition((h/2) < ima.nrows());
@@ -113,18 +193,27 @@ namespace scribo
 
       int row, col;
 
+      // Index of the current row of sites.
+      unsigned index = 0;
+
       for (col = col_0; col <= max_col_mid; col += step) ;
       int w_right = ncols - col + w/2;
 
       Ptr
 	d_tl_start, d_tr_start,
-	b_ml_start = 0, d_ml_start = 0, b_mr_start = 0, d_mr_start = 0,
-	b_bl_start = 0, d_bl_start = 0, b_br_start = 0, d_br = 0;
+	b_ml_start = Ptr(), d_ml_start = Ptr(),
+	b_mr_start = Ptr(), d_mr_start = Ptr(),
+	b_bl_start = Ptr(), d_bl_start = Ptr(),
+	b_br_start = Ptr(), d_br = Ptr();
 
       double mean, stddev;
 
       unsigned s_2 = s * s;
 
+      // Window sums of a run of sites in the image center.
+      enum { chunk = 256 };
+      double sum[chunk], sum_2[chunk];
+
       // -------------------------------
       //           T (top)
       // -------------------------------
@@ -142,11 +231,22 @@ namespace scribo
 	size_tr_start = h_top * w_right,
 	size_tr;
 
-      d_tl_start = & ima.at_(row_0 + h/2, col_0 + w/2);
-      d_tr_start = & ima.at_(row_0 + h/2, ncols - 1);
+      d_tl_start = traits::at(ima, row_0 + h/2, col_0 + w/2);
+      d_tr_start = traits::at(ima, row_0 + h/2, ncols - 1);
 
-      for (row = row_0; row <= max_row_top; row += step)
+      for (row = row_0; row <= max_row_top; row += step, ++index)
       {
+	if (index < row_begin || index >= row_end)
+	{
+	  delta_size_tl += step_2;
+	  size_tl_start += delta_start_left;
+	  d_tl_start += offset_down;
+	  size_tc += step_w;
+	  delta_size_tr += step_2;
+	  size_tr_start += delta_start_right;
+	  d_tr_start += offset_down;
+	  continue;
+	}
 
 	// TL (top left)
 
@@ -190,9 +290,8 @@ namespace scribo
 	// TR (top right)
 
 	d_ima = d_tr_start;
-	double
-	  d_sum   = d_ima->first(),
-	  d_sum_2 = d_ima->second();
+	S d_sum = d_ima->first();
+	S2 d_sum_2 = d_ima->second();
 	size_tr = size_tr_start;
 
 	for (; col < ncols; col += step)
@@ -230,14 +329,22 @@ namespace scribo
 
       if (row <= max_row_mid)
       {
-	b_ml_start = & ima.at_(row - h/2 - 1, col_0 + w/2);
+	b_ml_start = traits::at(ima, row - h/2 - 1, col_0 + w/2);
 	d_ml_start = b_ml_start + offset_below;
-	b_mr_start = & ima.at_(row - h/2 - 1, ncols - 1);
+	b_mr_start = traits::at(ima, row - h/2 - 1, ncols - 1);
 	d_mr_start = b_mr_start + offset_below;
       }
 
-      for (; row <= max_row_mid; row += step)
+      for (; row <= max_row_mid; row += step, ++index)
       {
+	if (index < row_begin || index >= row_end)
+	{
+	  b_ml_start += offset_down;
+	  d_ml_start += offset_down;
+	  b_mr_start += offset_down;
+	  d_mr_start += offset_down;
+	  continue;
+	}
 
 	// ML (middle left)
 
@@ -266,21 +373,22 @@ namespace scribo
 	a_ima = b_ima + offset_ante;
 	c_ima = d_ima + offset_ante;
 
-	for (; col <= max_col_mid; col += step)
+	while (col <= max_col_mid)
 	{
-	  // D + A - B - C
-
-	  internal::compute_stats((d_ima->first()   - b_ima->first())   + (a_ima->first()   - c_ima->first()),
-				  (d_ima->second() - b_ima->second()) + (a_ima->second() - c_ima->second()),
-				  size_mc * s_2,
-				  mean, stddev);
-
-	  functor.exec(mean, stddev);
-
-	  a_ima += step;
-	  b_ima += step;
-	  c_ima += step;
-	  d_ima += step;
+	  unsigned n = 0;
+	  for (; col <= max_col_mid && n < chunk; col += step, ++n)
+	  {
+	    // D + A - B - C
+	    sum[n]   = (d_ima->first()   - b_ima->first())   + (a_ima->first()   - c_ima->first());
+	    sum_2[n] = (d_ima->second() - b_ima->second()) + (a_ima->second() - c_ima->second());
+
+	    a_ima += step;
+	    b_ima += step;
+	    c_ima += step;
+	    d_ima += step;
+	  }
+
+	  functor.exec_row(sum, sum_2, n, size_mc * s_2);
 	}
 
 	// MR (middle right)
@@ -288,9 +396,8 @@ namespace scribo
 	size_mr = size_mr_start;
 	b_ima = b_mr_start;
 	d_ima = d_mr_start;
-	double
-	  d_b_sum   = d_ima->first()   - b_ima->first(),
-	  d_b_sum_2 = d_ima->second() - b_ima->second();
+	S d_b_sum = d_ima->first() - b_ima->first();
+	S2 d_b_sum_2 = d_ima->second() - b_ima->second();
 
 	for (; col < ncols; col += step)
 	{
@@ -326,14 +433,25 @@ namespace scribo
 
       if (row < nrows)
       {
-	b_bl_start = & ima.at_(row - h/2 - 1, col_0 + w/2);
-	d_bl_start = & ima.at_(nrows - 1, col_0 + w/2);
-	b_br_start = & ima.at_(row - h/2 - 1, ncols - 1);
-	d_br = & ima.at_(nrows - 1, ncols - 1);
+	b_bl_start = traits::at(ima, row - h/2 - 1, col_0 + w/2);
+	d_bl_start = traits::at(ima, nrows - 1, col_0 + w/2);
+	b_br_start = traits::at(ima, row - h/2 - 1, ncols - 1);
+	d_br = traits::at(ima, nrows - 1, ncols - 1);
       }
 
-      for (; row < nrows; row += step)
+      for (; row < nrows; row += step, ++index)
       {
+	if (index < row_begin || index >= row_end)
+	{
+	  delta_size_bl -= step_2;
+	  size_bl_start -= delta_start_left;
+	  b_bl_start += offset_down;
+	  size_bc -= step_w;
+	  delta_size_br -= step_2;
+	  size_br_start -= delta_start_right;
+	  b_br_start += offset_down;
+	  continue;
+	}
 
 	// BL (bottom left)
 
@@ -384,9 +502,8 @@ namespace scribo
 	size_br = size_br_start;
 	b_ima = b_br_start;
 	d_ima = d_br;
-	double
-	  d_b_sum   = d_ima->first()   - b_ima->first(),
-	  d_b_sum_2 = d_ima->second() - b_ima->second();
+	S d_b_sum = d_ima->first() - b_ima->first();
+	S2 d_b_sum_2 = d_ima->second() - b_ima->second();
 
 	for (; col < ncols; col += step)
 	{
@@ -35,8 +35,17 @@
 
 # include <QtGui/QImage>
 
+# include <cstring>
+
+# ifdef __SSE2__
+#  include <emmintrin.h>
+# endif // ! __SSE2__
+
 # include <mln/core/image/image2d.hh>
+# include <mln/core/alias/box2d.hh>
+# include <mln/make/box2d.hh>
 # include <mln/value/qt/rgb32.hh>
+# include <mln/value/int_u8.hh>
 
 # if QT_VERSION < 0x040000
 #  error "Qt library too old. You need at least Qt 4.x."
@@ -60,8 +69,108 @@ namespace scribo
     from_qimage(const QImage& ima);
 
 
+    /*! \brief Wrap the pixels of a QImage in a mln::image2d without
+      copying them.
+
+      \param[in] ima A QImage in QImage::Format_RGB32 or
+      QImage::Format_ARGB32 format, without padding at the end of
+      its rows.
+
+      \return A RGB8 2D image without border sharing the pixel
+      buffer of \p ima. It must be used read-only and must not
+      outlive \p ima.
+     */
+    mln::image2d<mln::value::qt::rgb32>
+    from_qimage_view(const QImage& ima);
+
+
+    /*! \brief Convert a QImage to a gray level mln::image2d.
+
+      Each pixel is read once and converted with the same formula as
+      mln::fun::v2v::qt_rgb_to_int_u, without building an
+      intermediate RGB image.
+
+      \param[in] ima A QImage. QImage::Format_RGB32,
+      QImage::Format_ARGB32, QImage::Format_Indexed8 (and
+      QImage::Format_Grayscale8 with Qt 5) are read directly; other
+      formats are converted to QImage::Format_RGB32 first.
+
+      \return A gray level 2D image in Milena's format.
+     */
+    mln::image2d<mln::value::int_u8>
+    from_qimage_to_int_u8(const QImage& ima);
+
+
+    /*! \brief Read the rows of a QImage as gray levels, converted as
+      with from_qimage_to_int_u8().
+
+      It provides the read_row() interface of the row by row
+      algorithms, e.g. scribo::binarization::sauvola_ms_read().
+     */
+    class qimage_int_u8_row_reader
+    {
+    public:
+      qimage_int_u8_row_reader(const QImage& ima);
+
+      int nrows() const;
+      int ncols() const;
+
+      /// Convert the next row of the image into \p row.
+      void read_row(mln::value::int_u8* row);
+
+    private:
+      QImage ima_;
+
+      // Gray levels of the color table.
+      unsigned char lut_[256];
+
+      int row_;
+    };
+
+
 # ifndef MLN_INCLUDE_ONLY
 
+    namespace internal
+    {
+
+      /// Convert a row of \p n 32-bit pixels to gray levels.
+      inline
+      void
+      rgb32_row_to_int_u8(const uchar* src_, unsigned char* dst, unsigned n)
+      {
+	const quint32* src = reinterpret_cast<const quint32*>(src_);
+	unsigned i = 0;
+
+#  ifdef __SSE2__
+	// 16 pixels per iteration.  r + g + b <= 765 fits in 16 bits
+	// and (s * 21846) >> 16 == s / 3 for s in [0, 765].
+	const __m128i mask = _mm_set1_epi32(0xff);
+	const __m128i third = _mm_set1_epi16(21846);
+	for (; i + 16 <= n; i += 16)
+	{
+	  __m128i sum[4];
+	  for (unsigned k = 0; k < 4; ++k)
+	  {
+	    __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4 * k));
+	    __m128i b = _mm_and_si128(p, mask);
+	    __m128i g = _mm_and_si128(_mm_srli_epi32(p, 8), mask);
+	    __m128i r = _mm_and_si128(_mm_srli_epi32(p, 16), mask);
+	    sum[k] = _mm_add_epi32(_mm_add_epi32(r, g), b);
+	  }
+	  __m128i lo = _mm_mulhi_epu16(_mm_packs_epi32(sum[0], sum[1]), third);
+	  __m128i hi = _mm_mulhi_epu16(_mm_packs_epi32(sum[2], sum[3]), third);
+	  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+			   _mm_packus_epi16(lo, hi));
+	}
+#  endif // ! __SSE2__
+
+	for (; i < n; ++i)
+	  dst[i] = (qRed(src[i]) + qGreen(src[i]) + qBlue(src[i])) / 3;
+      }
+
+    } // end of namespace scribo::convert::internal
+
+
     mln::image2d<mln::value::qt::rgb32>
     from_qimage(const QImage& ima)
     {
@@ -84,6 +193,117 @@ namespace scribo
       return output;
     }
 
+
+    inline
+    mln::image2d<mln::value::qt::rgb32>
+    from_qimage_view(const QImage& ima)
+    {
+      mln_precondition(ima.format() == QImage::Format_RGB32
+		       || ima.format() == QImage::Format_ARGB32);
+      mln_precondition(ima.bytesPerLine() == ima.width() * 4);
+
+      // The const version of bits() does not detach the image.
+      uchar* bits = const_cast<uchar*>(ima.bits());
+
+      return mln::image2d<mln::value::qt::rgb32>(
+	reinterpret_cast<mln::value::qt::rgb32*>(bits),
+	mln::make::box2d(ima.height(), ima.width()));
+    }
+
+
+    inline
+    qimage_int_u8_row_reader::qimage_int_u8_row_reader(const QImage& ima)
+      : ima_(ima),
+	row_(0)
+    {
+      switch (ima.format())
+      {
+	case QImage::Format_RGB32:
+	case QImage::Format_ARGB32:
+	case QImage::Format_Indexed8:
+#  if QT_VERSION >= 0x050500
+	case QImage::Format_Grayscale8:
+#  endif // ! QT_VERSION
+	  break;
+
+	default:
+	  ima_ = ima.convertToFormat(QImage::Format_RGB32);
+      }
+
+      if (ima_.format() == QImage::Format_Indexed8)
+      {
+	const QVector<QRgb> colors = ima_.colorTable();
+	for (int i = 0; i < 256; ++i)
+	  lut_[i] = i < colors.size()
+	    ? (qRed(colors[i]) + qGreen(colors[i]) + qBlue(colors[i])) / 3
+	    : 0;
+      }
+    }
+
+
+    inline
+    int
+    qimage_int_u8_row_reader::nrows() const
+    {
+      return ima_.height();
+    }
+
+
+    inline
+    int
+    qimage_int_u8_row_reader::ncols() const
+    {
+      return ima_.width();
+    }
+
+
+    inline
+    void
+    qimage_int_u8_row_reader::read_row(mln::value::int_u8* row)
+    {
+      mln_precondition(row_ < ima_.height());
+
+      const uchar* src = ima_.constScanLine(row_++);
+      unsigned char* dst = reinterpret_cast<unsigned char*>(row);
+      const int ncols = ima_.width();
+
+      switch (ima_.format())
+      {
+	case QImage::Format_Indexed8:
+	  for (int col = 0; col < ncols; ++col)
+	    dst[col] = lut_[src[col]];
+	  break;
+
+#  if QT_VERSION >= 0x050500
+	case QImage::Format_Grayscale8:
+	  std::memcpy(dst, src, ncols);
+	  break;
+#  endif // ! QT_VERSION
+
+	default:
+	  internal::rgb32_row_to_int_u8(src, dst, ncols);
+      }
+    }
+
+
+    inline
+    mln::image2d<mln::value::int_u8>
+    from_qimage_to_int_u8(const QImage& ima)
+    {
+      qimage_int_u8_row_reader reader(ima);
+
+      const int
+	nrows = reader.nrows(),
+	ncols = reader.ncols();
+
+      mln::image2d<mln::value::int_u8> output(nrows, ncols);
+
+      for (int row = 0; row < nrows; ++row)
+	reader.read_row(&output.at_(row, 0));
+
+      return output;
+    }
+
 # endif // ! MLN_INCLUDE_ONLY
 
   } // end of namespace scribo::convert
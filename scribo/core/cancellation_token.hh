@@ -0,0 +1,178 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+#ifndef SCRIBO_CORE_CANCELLATION_TOKEN_HH
+# define SCRIBO_CORE_CANCELLATION_TOKEN_HH
+
+/// \file
+///
+/// \brief Cooperative cancellation of long running routines.
+
+# include <exception>
+
+# ifdef _WIN32
+#  include <windows.h>
+# else
+#  include <sys/time.h>
+# endif
+
+# include <scribo/core/internal/mutex.hh>
+
+
+namespace scribo
+{
+
+  /// \brief Exception thrown at a checkpoint when the running
+  /// routine has been canceled.
+  //
+  struct canceled : public std::exception
+  {
+    virtual const char* what() const throw();
+  };
+
+
+  /// \brief Cancellation request and time budget shared between a
+  /// routine and its caller.
+  ///
+  /// The routine checks is_canceled() at some checkpoints (between
+  /// toolchain stages, between text lines...) and stops as soon as
+  /// possible once it returns true.  A token may have a parent: it
+  /// is then also canceled when its parent is.
+  ///
+  /// All the methods are thread-safe.
+  //
+  class cancellation_token
+  {
+  public:
+    cancellation_token(const cancellation_token* parent = 0);
+
+    /// Request cancellation.
+    void cancel();
+
+    /// Cancel automatically \p msecs milliseconds from now.
+    void set_time_budget(unsigned msecs);
+
+    /// Return true if cancel() has been called, if the time budget
+    /// is exhausted or if the parent is canceled.
+    bool is_canceled() const;
+
+    /// Throw scribo::canceled if is_canceled() is true.
+    void check() const;
+
+  private:
+    // Not copyable.
+    cancellation_token(const cancellation_token&);
+    cancellation_token& operator=(const cancellation_token&);
+
+    /// Wall clock time, in milliseconds.
+    static double now();
+
+    const cancellation_token* parent_;
+    bool canceled_;
+    bool has_deadline_;
+    double deadline_;
+    mutable internal::mutex mutex_;
+  };
+
+
+# ifndef MLN_INCLUDE_ONLY
+
+  // canceled
+
+  inline
+  const char*
+  canceled::what() const throw()
+  {
+    return "scribo: canceled";
+  }
+
+
+  // cancellation_token
+
+  inline
+  cancellation_token::cancellation_token(const cancellation_token* parent)
+    : parent_(parent),
+      canceled_(false),
+      has_deadline_(false),
+      deadline_(0)
+  {
+  }
+
+  inline
+  void
+  cancellation_token::cancel()
+  {
+    internal::scoped_lock lock(mutex_);
+    canceled_ = true;
+  }
+
+  inline
+  void
+  cancellation_token::set_time_budget(unsigned msecs)
+  {
+    internal::scoped_lock lock(mutex_);
+    has_deadline_ = true;
+    deadline_ = now() + msecs;
+  }
+
+  inline
+  bool
+  cancellation_token::is_canceled() const
+  {
+    {
+      internal::scoped_lock lock(mutex_);
+      if (canceled_ || (has_deadline_ && now() >= deadline_))
+	return true;
+    }
+
+    return parent_ != 0 && parent_->is_canceled();
+  }
+
+  inline
+  void
+  cancellation_token::check() const
+  {
+    if (is_canceled())
+      throw canceled();
+  }
+
+  inline
+  double
+  cancellation_token::now()
+  {
+#  ifdef _WIN32
+    return GetTickCount();
+#  else
+    timeval t;
+    gettimeofday(&t, 0);
+    return t.tv_sec * 1000. + t.tv_usec / 1000.;
+#  endif
+  }
+
+# endif // ! MLN_INCLUDE_ONLY
+
+} // end of namespace scribo
+
+#endif // ! SCRIBO_CORE_CANCELLATION_TOKEN_HH
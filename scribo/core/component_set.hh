@@ -44,6 +44,7 @@
 # include <mln/accu/shape/bbox.hh>
 
 # include <mln/labeling/compute.hh>
+# include <mln/labeling/value_and_compute.hh>
 # include <mln/labeling/relabel.hh>
 
 # include <mln/logical/or.hh>
@@ -87,6 +88,8 @@ namespace scribo
 			 const mln::util::array<pair_accu_t>& attribs);
       component_set_data(const L& ima, const mln_value(L)& ncomps,
 			 const mln::util::array<pair_data_t>& attribs);
+      component_set_data(const L& ima, const mln_value(L)& ncomps,
+			 const mln::labeling::attributes2d& attribs);
 
       component_set_data(const L& ima, const mln_value(L)& ncomps,
 			 const mln::util::array<scribo::component_info>& infos);
@@ -95,6 +98,8 @@ namespace scribo
 
       void fill_infos(const mln::util::array<pair_data_t>& attribs);
 
+      void fill_infos(const mln::labeling::attributes2d& attribs);
+
 
       L ima_;
       mln_value(L) ncomps_;
@@ -138,6 +143,11 @@ namespace scribo
 
     component_set(const L& ima, const mln_value(L)& ncomps,
 		  const mln::util::array<pair_data_t>& attribs);
+
+    /// Constructor from an image \p ima, the number of labels \p ncomps and
+    /// attributes arrays (bounding box, mass center and cardinality).
+    component_set(const L& ima, const mln_value(L)& ncomps,
+		  const mln::labeling::attributes2d& attribs);
     /// @}
 
     /// Return the component count.
@@ -299,6 +309,19 @@ namespace scribo
       fill_infos(attribs);
     }
 
+    template <typename L>
+    inline
+    component_set_data<L>::component_set_data(const L& ima,
+					      const mln_value(L)& ncomps,
+					      const mln::labeling::attributes2d& attribs)
+      : ima_(ima), ncomps_(ncomps)
+    {
+      initialize(separators_, ima);  // FIXME: do we really want that?
+      mln::data::fill(separators_, false);
+
+      fill_infos(attribs);
+    }
+
     template <typename L>
     inline
     component_set_data<L>::component_set_data(const L& ima,
@@ -348,6 +371,25 @@ namespace scribo
     }
 
 
+    template <typename L>
+    inline
+    void
+    component_set_data<L>::fill_infos(const mln::labeling::attributes2d& attribs)
+    {
+      mln_precondition(attribs.card.size() == unsigned(ncomps_) + 1);
+
+      infos_.reserve(mln::value::next(ncomps_));
+
+      infos_.append(component_info()); // Component 0, i.e. the background.
+      for (unsigned i = 1; i <= unsigned(ncomps_); ++i)
+      {
+	component_info info(i, attribs.bbox(i),
+			    attribs.mass_center(i), attribs.card[i]);
+	infos_.append(info);
+      }
+    }
+
+
   } // end of namespace mln::internal
 
 
@@ -386,6 +428,15 @@ namespace scribo
   }
 
 
+  template <typename L>
+  inline
+  component_set<L>::component_set(const L& ima, const mln_value(L)& ncomps,
+				  const mln::labeling::attributes2d& attribs)
+  {
+    data_ = new internal::component_set_data<L>(ima, ncomps, attribs);
+  }
+
+
   template <typename L>
   inline
 
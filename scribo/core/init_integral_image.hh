@@ -32,6 +32,10 @@
 ///
 
 # include <mln/core/image/image2d.hh>
+# include <mln/metal/equal.hh>
+# include <mln/value/int_u8.hh>
+
+# include <scribo/core/integral_image.hh>
 
 namespace scribo
 {
@@ -42,6 +46,15 @@ namespace scribo
   mln_ch_value(I,double)
   init_integral_image(const Image<I>& input_, F& func);
 
+  /// \brief Compute the integral images of the values and of the
+  /// squared values of an 8-bit image, in integer planes.
+  ///
+  /// \p output has the domain of \p input.
+  //
+  template <typename I>
+  void
+  init_integral_image(const Image<I>& input, integral_image& output);
+
 
 # ifndef MLN_INCLUDE_ONLY
 
@@ -103,6 +116,60 @@ namespace scribo
     return output;
   }
 
+
+  template <typename I>
+  void
+  init_integral_image(const Image<I>& input_, integral_image& output)
+  {
+    trace::entering("scribo::init_integral_image");
+
+    const I& input = exact(input_);
+    mlc_equal(mln_value(I), value::int_u8)::check();
+    mln_precondition(input.is_valid());
+    mln_precondition(input.domain().pmin() == literal::origin);
+
+    typedef integral_image::sum_t S;
+    typedef integral_image::sum_2_t S2;
+
+    output.init_(input.domain(), input.border());
+
+    unsigned
+      nrows_ = input.nrows(),
+      ncols_ = input.ncols();
+
+    // Each row is the row above plus the running sums of the row.
+    for (unsigned row = 0; row < nrows_; ++row)
+    {
+      const value::int_u8* p_in = & input.at_(row, 0);
+      S* p_sum = & output.sum.at_(row, 0);
+      S2* p_sum_2 = & output.sum_2.at_(row, 0);
+
+      S h_sum = 0;
+      S2 h_sum_2 = 0;
+      for (unsigned col = 0; col < ncols_; ++col)
+      {
+	unsigned v = p_in[col];
+	h_sum += v;
+	h_sum_2 += v * v;
+	p_sum[col] = h_sum;
+	p_sum_2[col] = h_sum_2;
+      }
+
+      if (row > 0)
+      {
+	const S* p_sum_up = & output.sum.at_(row - 1, 0);
+	const S2* p_sum_2_up = & output.sum_2.at_(row - 1, 0);
+	for (unsigned col = 0; col < ncols_; ++col)
+	{
+	  p_sum[col] += p_sum_up[col];
+	  p_sum_2[col] += p_sum_2_up[col];
+	}
+      }
+    }
+
+    trace::exiting("scribo::init_integral_image");
+  }
+
 #endif // ! MLN_INCLUDE_ONLY
 
 } // end of namespace scribo
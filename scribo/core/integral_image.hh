@@ -0,0 +1,231 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+#ifndef SCRIBO_CORE_INTEGRAL_IMAGE_HH
+# define SCRIBO_CORE_INTEGRAL_IMAGE_HH
+
+/// \file
+///
+/// \brief Integer integral images of an 8-bit image.
+
+# include <mln/core/image/image2d.hh>
+# include <mln/core/alias/box2d.hh>
+# include <mln/core/alias/dpoint2d.hh>
+
+
+namespace scribo
+{
+
+  using namespace mln;
+
+
+  /*! \brief Integral images of the values and of the squared values
+      of an 8-bit image, stored in two integer planes.
+
+      Both planes have the same domain and border, so that offsets
+      computed on one of them are valid on the other.
+
+      The sums are stored modulo 2^32 and the squared sums modulo
+      2^64. The sums over a window, computed from its four corners
+      with unsigned arithmetic, are nevertheless exact as long as
+      they fit: up to 2^24 pixels for the sums and 2^47 pixels for
+      the squared sums. Unlike double precision integral images,
+      they do not drift on large images.
+  */
+  struct integral_image
+  {
+    typedef unsigned           sum_t;
+    typedef unsigned long long sum_2_t;
+
+
+    /// Pointer-like access to both planes at the same site.
+    class cursor
+    {
+    public:
+      cursor();
+      cursor(const sum_t* sum, const sum_2_t* sum_2);
+
+      /// The sum at the current site.
+      sum_t first() const;
+
+      /// The squared sum at the current site.
+      sum_2_t second() const;
+
+      const cursor* operator->() const;
+
+      cursor& operator+=(int offset);
+      cursor operator+(int offset) const;
+
+    private:
+      const sum_t* sum_;
+      const sum_2_t* sum_2_;
+    };
+
+
+    /// Allocate both planes.
+    void init_(const box2d& b, unsigned bdr);
+
+    bool is_valid() const;
+
+    const box2d& domain() const;
+    unsigned nrows() const;
+    unsigned ncols() const;
+    unsigned border() const;
+
+    /// Offset corresponding to \p dp in both planes.
+    int delta_index(const dpoint2d& dp) const;
+
+    /// Access both planes at (\p row, \p col).
+    cursor ptr(mln::def::coord row, mln::def::coord col) const;
+
+
+    image2d<sum_t> sum;
+    image2d<sum_2_t> sum_2;
+  };
+
+
+
+# ifndef MLN_INCLUDE_ONLY
+
+
+  // integral_image::cursor
+
+  inline
+  integral_image::cursor::cursor()
+    : sum_(0), sum_2_(0)
+  {
+  }
+
+  inline
+  integral_image::cursor::cursor(const sum_t* sum, const sum_2_t* sum_2)
+    : sum_(sum), sum_2_(sum_2)
+  {
+  }
+
+  inline
+  integral_image::sum_t
+  integral_image::cursor::first() const
+  {
+    return *sum_;
+  }
+
+  inline
+  integral_image::sum_2_t
+  integral_image::cursor::second() const
+  {
+    return *sum_2_;
+  }
+
+  inline
+  const integral_image::cursor*
+  integral_image::cursor::operator->() const
+  {
+    return this;
+  }
+
+  inline
+  integral_image::cursor&
+  integral_image::cursor::operator+=(int offset)
+  {
+    sum_ += offset;
+    sum_2_ += offset;
+    return *this;
+  }
+
+  inline
+  integral_image::cursor
+  integral_image::cursor::operator+(int offset) const
+  {
+    cursor tmp = *this;
+    return tmp += offset;
+  }
+
+
+  // integral_image
+
+  inline
+  void
+  integral_image::init_(const box2d& b, unsigned bdr)
+  {
+    sum.init_(b, bdr);
+    sum_2.init_(b, bdr);
+  }
+
+  inline
+  bool
+  integral_image::is_valid() const
+  {
+    return sum.is_valid() && sum_2.is_valid();
+  }
+
+  inline
+  const box2d&
+  integral_image::domain() const
+  {
+    return sum.domain();
+  }
+
+  inline
+  unsigned
+  integral_image::nrows() const
+  {
+    return sum.nrows();
+  }
+
+  inline
+  unsigned
+  integral_image::ncols() const
+  {
+    return sum.ncols();
+  }
+
+  inline
+  unsigned
+  integral_image::border() const
+  {
+    return sum.border();
+  }
+
+  inline
+  int
+  integral_image::delta_index(const dpoint2d& dp) const
+  {
+    mln_precondition(sum.delta_index(dp) == sum_2.delta_index(dp));
+    return sum.delta_index(dp);
+  }
+
+  inline
+  integral_image::cursor
+  integral_image::ptr(mln::def::coord row, mln::def::coord col) const
+  {
+    return cursor(& sum.at_(row, col), & sum_2.at_(row, col));
+  }
+
+
+# endif // ! MLN_INCLUDE_ONLY
+
+} // end of namespace scribo
+
+#endif // ! SCRIBO_CORE_INTEGRAL_IMAGE_HH
@@ -0,0 +1,155 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+#ifndef SCRIBO_CORE_INTERNAL_MUTEX_HH
+# define SCRIBO_CORE_INTERNAL_MUTEX_HH
+
+/// \file
+///
+/// \brief Minimal mutex used to protect process-wide Scribo data
+/// (e.g. the OCR engine pool) when the toolchain runs in several
+/// threads.
+
+# ifdef _WIN32
+#  include <windows.h>
+# else
+#  include <pthread.h>
+# endif
+
+
+namespace scribo
+{
+
+  namespace internal
+  {
+
+    /// Non-recursive mutex.
+    class mutex
+    {
+    public:
+      mutex();
+      ~mutex();
+
+      void lock();
+      void unlock();
+
+    private:
+      // Not copyable.
+      mutex(const mutex&);
+      mutex& operator=(const mutex&);
+
+# ifdef _WIN32
+      CRITICAL_SECTION m_;
+# else
+      pthread_mutex_t m_;
+# endif
+    };
+
+
+    /// Lock a mutex for the lifetime of this object.
+    class scoped_lock
+    {
+    public:
+      scoped_lock(mutex& m);
+      ~scoped_lock();
+
+    private:
+      // Not copyable.
+      scoped_lock(const scoped_lock&);
+      scoped_lock& operator=(const scoped_lock&);
+
+      mutex& m_;
+    };
+
+
+# ifndef MLN_INCLUDE_ONLY
+
+    // mutex
+
+    inline
+    mutex::mutex()
+    {
+#  ifdef _WIN32
+      InitializeCriticalSection(&m_);
+#  else
+      pthread_mutex_init(&m_, 0);
+#  endif
+    }
+
+    inline
+    mutex::~mutex()
+    {
+#  ifdef _WIN32
+      DeleteCriticalSection(&m_);
+#  else
+      pthread_mutex_destroy(&m_);
+#  endif
+    }
+
+    inline
+    void
+    mutex::lock()
+    {
+#  ifdef _WIN32
+      EnterCriticalSection(&m_);
+#  else
+      pthread_mutex_lock(&m_);
+#  endif
+    }
+
+    inline
+    void
+    mutex::unlock()
+    {
+#  ifdef _WIN32
+      LeaveCriticalSection(&m_);
+#  else
+      pthread_mutex_unlock(&m_);
+#  endif
+    }
+
+
+    // scoped_lock
+
+    inline
+    scoped_lock::scoped_lock(mutex& m)
+      : m_(m)
+    {
+      m_.lock();
+    }
+
+    inline
+    scoped_lock::~scoped_lock()
+    {
+      m_.unlock();
+    }
+
+# endif // ! MLN_INCLUDE_ONLY
+
+  } // end of namespace scribo::internal
+
+} // end of namespace scribo
+
+#endif // ! SCRIBO_CORE_INTERNAL_MUTEX_HH
@@ -396,7 +396,7 @@ namespace scribo
   bool
   line_set<L>::is_valid() const
   {
-    return data_->links_.is_valid() && data_->groups_.is_valid();
+    return data_ && data_->links_.is_valid() && data_->groups_.is_valid();
   }
 
   template <typename L>
@@ -53,6 +53,7 @@ namespace scribo
 # include <scribo/preprocessing/homogeneous_contrast.hh>
 
 # include <scribo/preprocessing/rotate_90.hh>
+# include <scribo/preprocessing/rotate_shear.hh>
 
 # include <scribo/preprocessing/split_bg_fg.hh>
 
@@ -33,14 +33,16 @@
 /// \FIXME: provide a version for binary images.
 
 
-# include <queue>
+# include <cmath>
+# include <vector>
+# include <algorithm>
 
 # include <mln/core/image/image2d.hh>
 # include <mln/math/pi.hh>
 # include <mln/geom/rotate.hh>
 # include <mln/value/int_u8.hh>
 
-# define PI 3.1415926535897932384
+# include <scribo/preprocessing/rotate_shear.hh>
 
 namespace scribo
 {
@@ -53,387 +55,524 @@ namespace scribo
     namespace internal
     {
 
-      class Hough
+      /// A site voting for the skew angle.
+      struct skew_voter
       {
-      public:
-	Hough(int width, int height);
+	/// Coordinates relative to the center of the voting image.
+	int x;
+	int y;
+      };
 
-	~Hough();
 
-	void look_up_table();
+      /*! \brief Fixed-point sine and cosine of the skew angles.
 
-	int width() const;
+	Angles are expressed in tenths of degree, from -250 to 250.
+       */
+      struct skew_lut
+      {
+	enum { max_angle = 250, shift = 14 };
 
-	int height() const;
+	skew_lut();
+
+	int cos_[2 * max_angle + 1];
+	int sin_[2 * max_angle + 1];
+      };
 
-	double mtheta() const;
-	double mrho() const;
 
-	int mrhoi() const;
-	int mthetai() const;
+      /*! \brief Hough accumulator for the skew angles \p first,
+	\p first + \p step, ... up to \p last.
 
-	double get_cos(int index) const;
-	double get_sin(int index) const;
+	A line of skew angle \p a goes through the sites (x, y) such
+	that x * sin(a) + y * cos(a) = rho.
+       */
+      class skew_hough
+      {
+      public:
+	skew_hough(const skew_lut& lut, unsigned max_rho,
+		   int first, int last, int step);
 
-	image2d<unsigned>& acc();
+	/// Vote for all the angles.
+	void vote(const skew_voter& v);
 
-      private:
-	int width_;
-	int height_;
+	/// Add the votes of \p other.
+	void merge(const skew_hough& other);
 
-	double max_rho_;
-	double max_theta_;
+	/// Return the angle whose lines are the most contrasted.
+	/// \p confidence is set to the relative difference between
+	/// the contrast of this angle and the mean contrast.
+	int best_angle(double& confidence) const;
 
-	int max_rho_index_;
-	int max_theta_index_;
+      private:
+	const skew_lut* lut_;
 
-	double* cos_;
-	double* sin_;
+	int nrho_;
+	int first_;
+	int last_;
+	int step_;
 
-	image2d<unsigned> acc_;
+	std::vector<unsigned> acc_;
       };
 
+    } // end of namespace scribo::preprocessing::internal
 
-      struct s_angle
-      {
-	int pos;
-	unsigned max;
-      };
 
+    /*! \brief Deskew a gray level image.
 
-      struct QCompare
-      {
-	bool operator()(const s_angle&	s1, const s_angle& s2);
-      };
+      \param[in] input_gl A gray level image.
 
-    } // end of namespace scribo::preprocessing::internal
+      \return The rotated image, or \p input_gl itself if the skew
+      angle is too small to be worth a rotation.
+     */
+    template <typename I>
+    mln_concrete(I)
+    deskew(const Image<I>& input_gl);
+
+    /// \overload
+    /// \p rotated is set to true if the image was rotated.
+    //
+    template <typename I>
+    mln_concrete(I)
+    deskew(const Image<I>& input_gl, bool& rotated);
 
 
+    /*! \brief Estimate the skew angle of a gray level image.
 
-# ifndef MLN_INCLUDE_ONLY
+      \param[in]  input_gl   A gray level image.
+      \param[out] confidence Set to a value in [0, 1], close to 0 if
+                             no text line was found.
+      \param[in]  nthreads   The number of threads used if OpenMP is
+                             available.
 
-    namespace internal
-    {
+      \return The skew angle in degrees, from -25 to +25. The image
+      is deskewed by a rotation of minus this angle.
+     */
+    template <typename I>
+    double
+    skew_angle(const Image<I>& input_gl, double& confidence,
+	       unsigned nthreads);
 
-      inline
-      bool
-      QCompare::operator()(const s_angle& s1, const s_angle& s2)
-      {
-	return (s1.max > s2.max);
-      }
 
+    /*! \brief Deskew a gray level image.
 
-      inline
-      Hough::Hough(int	width, int height)
-	: width_(width / 2),
-	  height_(height / 2),
-	  max_rho_(sqrt((width * width) + (height * height))),
-	  max_theta_(math::pi),
-	  max_rho_index_(int(this->max_rho_) + 1),
-	  max_theta_index_(500),
-	  acc_(this->max_rho_index_, this->max_theta_index_)
-      {
-	look_up_table();
-      }
+      \param[in]  input_gl   A gray level image.
+      \param[in]  min_angle  The image is not rotated if the absolute
+                             value of its skew angle is not greater.
+      \param[in]  nthreads   The number of threads used if OpenMP is
+                             available.
+      \param[out] angle      The skew angle, as returned by
+                             skew_angle().
+      \param[out] confidence The confidence of \p angle.
 
+      \return The rotated image, or \p input_gl itself.
+
+      The 8-bit images are rotated by three shears (see
+      rotate_shear()), the other ones by geom::rotate.
+     */
+    template <typename I>
+    mln_concrete(I)
+    deskew(const Image<I>& input_gl, double min_angle, unsigned nthreads,
+	   double& angle, double& confidence);
 
-      inline
-      Hough::~Hough()
-      {
-	delete[] this->cos_;
-	delete[] this->sin_;
-      }
 
 
+# ifndef MLN_INCLUDE_ONLY
+
+    namespace internal
+    {
+
       inline
-      void	Hough::look_up_table()
+      skew_lut::skew_lut()
       {
-	this->cos_ = new double[this->max_theta_index_];
-	this->sin_ = new double[this->max_theta_index_];
+	const double scale = 1 << shift;
 
-	for (int i = 0; i < this->max_theta_index_; ++i)
+	for (int a = -max_angle; a <= max_angle; ++a)
 	{
-	  double	i_val = (i + 650) * this->max_theta_ / 1800.0f;
+	  const double rad = a * math::pi / 1800.;
 
-	  this->cos_[i] = cos(i_val);
-	  this->sin_[i] = sin(i_val);
+	  cos_[a + max_angle] = int(std::floor(std::cos(rad) * scale + 0.5));
+	  sin_[a + max_angle] = int(std::floor(std::sin(rad) * scale + 0.5));
 	}
       }
 
-      inline
-      int	Hough::width() const
-      {
-	return this->width_;
-      }
 
       inline
-      int	Hough::height() const
+      skew_hough::skew_hough(const skew_lut& lut, unsigned max_rho,
+			     int first, int last, int step)
+	: lut_(&lut),
+	  nrho_(2 * max_rho + 1),
+	  first_(first),
+	  last_(last),
+	  step_(step),
+	  acc_(((last - first) / step + 1) * nrho_, 0u)
       {
-	return this->height_;
       }
 
-      inline
-      double	Hough::mtheta() const
-      {
-	return this->max_theta_;
-      }
 
       inline
-      double	Hough::mrho() const
+      void
+      skew_hough::vote(const skew_voter& v)
       {
-	return this->max_rho_;
+	// Rounding and shift to non-negative rho indices.
+	const int offset = ((nrho_ / 2) << skew_lut::shift)
+	  + (1 << (skew_lut::shift - 1));
+	const int* cos_a = lut_->cos_ + skew_lut::max_angle;
+	const int* sin_a = lut_->sin_ + skew_lut::max_angle;
+
+	unsigned* col = &acc_[0];
+	for (int a = first_; a <= last_; a += step_, col += nrho_)
+	  ++col[(v.x * sin_a[a] + v.y * cos_a[a] + offset) >> skew_lut::shift];
       }
 
-      inline
-      int	Hough::mrhoi() const
-      {
-	return this->max_rho_index_;
-      }
 
       inline
-      int	Hough::mthetai() const
+      void
+      skew_hough::merge(const skew_hough& other)
       {
-	return this->max_theta_index_;
-      }
+	mln_precondition(other.acc_.size() == acc_.size());
 
-      inline
-      double	Hough::get_cos(int	index) const
-      {
-	return this->cos_[index];
+	for (unsigned i = 0; i < acc_.size(); ++i)
+	  acc_[i] += other.acc_[i];
       }
 
-      inline
-      double	Hough::get_sin(int	index) const
-      {
-	return this->sin_[index];
-      }
 
       inline
-      image2d<unsigned>&	Hough::acc()
+      int
+      skew_hough::best_angle(double& confidence) const
       {
-	return this->acc_;
-      }
-
-      inline
-      static
-      void
-      vote(int x, int y, Hough& hough, int theta)
-      {
-	int	theta_min = std::max(theta - 25, 0);
-	int	theta_max = std::min(theta + 25, hough.mthetai());
-
-	x -= hough.width();
-	y -= hough.height();
-
-	for (int i = theta_min; i < theta_max; ++i)
+	// Lines are the most contrasted when the votes are
+	// concentrated on a few rho values.  Small angles may not move
+	// any vote to another rho value: the middle of a plateau of
+	// maxima is returned.
+	unsigned long long max = 0;
+	double sum = 0;
+	int
+	  plateau_first = first_,
+	  plateau_last = first_;
+
+	const unsigned* col = &acc_[0];
+	for (int a = first_; a <= last_; a += step_, col += nrho_)
 	{
-	  double rho = x * hough.get_cos(i) + y * hough.get_sin(i);
-	  double rho_index = (0.5 + (rho / hough.mrho() + 0.5)
-			      * hough.mrhoi());
+	  unsigned long long energy = 0;
+	  for (int r = 0; r < nrho_; ++r)
+	    energy += (unsigned long long) col[r] * col[r];
+	  sum += energy;
 
-	  ++(opt::at(hough.acc(),
-		     static_cast<mln::def::coord>(rho_index), i));
+	  if (energy > max)
+	  {
+	    max = energy;
+	    plateau_first = plateau_last = a;
+	  }
+	  else if (energy == max && plateau_last == a - step_)
+	    plateau_last = a;
 	}
+
+	const unsigned nangles = (last_ - first_) / step_ + 1;
+	confidence = max != 0 ? 1 - sum / nangles / max : 0;
+
+	return plateau_first
+	  + (plateau_last - plateau_first) / (2 * step_) * step_;
       }
 
 
+      /// Return the mean of each \p f x \p f block of \p gray.
       inline
-      static
-      void
-      init_hist(Hough&	hough, int hist[500],
-		std::priority_queue<s_angle, std::vector<s_angle>, QCompare>& q,
-		int nb_elm)
+      image2d<value::int_u8>
+      skew_subsample(const image2d<value::int_u8>& gray, unsigned f,
+		     unsigned nthreads)
       {
-	int max_rho = hough.mrhoi();
-	int max_theta = hough.mthetai();
-	unsigned max_elm = (nb_elm > max_rho) ? (nb_elm / max_rho) << 5 : 1;
-
-	for (int j = 0; j < max_theta; ++j)
+	const int
+	  nrows = gray.nrows() / f,
+	  ncols = gray.ncols() / f;
+	const unsigned area = f * f;
+
+	image2d<value::int_u8> output(nrows, ncols);
+
+#  ifdef _OPENMP
+#   pragma omp parallel num_threads(nthreads)
+#  else
+	(void) nthreads;
+#  endif // ! _OPENMP
 	{
-	  hist[j] = 0;
+	  std::vector<unsigned> sum(ncols);
 
-	  if (q.size() < max_elm)
+#  ifdef _OPENMP
+#   pragma omp for schedule(static)
+#  endif // ! _OPENMP
+	  for (int row = 0; row < nrows; ++row)
 	  {
-	    if (opt::at(hough.acc(), 0, j) > 0)
-	    {
-	      s_angle s;
-
-	      s.max = opt::at(hough.acc(), 0, j);
-	      s.pos = j;
+	    std::fill(sum.begin(), sum.end(), 0u);
 
-	      q.push(s);
+	    for (unsigned l = 0; l < f; ++l)
+	    {
+	      const value::int_u8* in = &gray.at_(row * f + l, 0);
+	      for (int col = 0; col < ncols; ++col)
+		for (unsigned k = 0; k < f; ++k)
+		  sum[col] += *in++;
 	    }
-	  }
-	  else if (opt::at(hough.acc(), 0, j) > q.top().max)
-	  {
-	    s_angle s;
-
-	    s.max = opt::at(hough.acc(), 0, j);
-	    s.pos = j;
 
-	    q.pop();
-	    q.push(s);
+	    value::int_u8* out = &output.at_(row, 0);
+	    for (int col = 0; col < ncols; ++col)
+	      *out++ = (sum[col] + area / 2) / area;
 	  }
 	}
+
+	return output;
       }
 
 
+      /*! \brief Select the sites of \p gray lying on the baselines.
+
+	Only the sites whose Sobel gradient is within 25 degrees of
+	the vertical are kept.
+       */
       inline
-      static
-      double
-      get_max(Hough& hough, int hist[500],
-	      std::priority_queue<s_angle, std::vector<s_angle>, QCompare>& q,
-	      int nb_elm)
+      void
+      skew_voters(const image2d<value::int_u8>& gray,
+		  std::vector<skew_voter>& voters, unsigned nthreads)
       {
-	int max = 0;
-	int h_value = 0;
-	int max_rho = hough.mrhoi();
-	int max_theta = hough.mthetai();
-	double pos = 0.f;
-	unsigned max_elm = (nb_elm > max_rho) ? (nb_elm / max_rho) << 5 : 1;
-
-
-	for (int i = 1; i < max_rho; ++i)
+	const int
+	  nrows = gray.nrows(),
+	  ncols = gray.ncols(),
+	  half_nrows = nrows / 2,
+	  half_ncols = ncols / 2;
+
+	// tan(25 degrees) in fixed point.
+	const int tan_max = 4663;
+
+#  ifdef _OPENMP
+#   pragma omp parallel num_threads(nthreads)
+#  else
+	(void) nthreads;
+#  endif // ! _OPENMP
 	{
-	  for (int j = 0; j < max_theta; ++j)
+	  std::vector<skew_voter> voters_t;
+
+#  ifdef _OPENMP
+#   pragma omp for schedule(static)
+#  endif // ! _OPENMP
+	  for (int i = 1; i < nrows - 1; ++i)
 	  {
-	    if (q.size() < max_elm)
+	    const value::int_u8
+	      *prev = &gray.at_(i - 1, 0),
+	      *cur = &gray.at_(i, 0),
+	      *next = &gray.at_(i + 1, 0);
+
+	    for (int j = 1; j < ncols - 1; ++j)
 	    {
-	      if (opt::at(hough.acc(), i, j) > 0)
-	      {
-		s_angle s;
+	      unsigned up = cur[j - 1] * cur[j] * cur[j + 1];
+	      unsigned down = next[j - 1] * next[j] * next[j + 1];
+	      unsigned mean = (cur[j] * next[j]) >> 8;
 
-		s.max = opt::at(hough.acc(), i, j);
-		s.pos = j;
+	      up = 255 - (up >> 16);
+	      down = down >> 16;
 
-		q.push(s);
-	      }
-	    }
-	    else if (opt::at(hough.acc(), i, j) > q.top().max)
-	    {
-	      s_angle s;
+	      if (!(up > down && down > mean && down > 130))
+		continue;
+
+	      const int gy = prev[j - 1] + 2 * prev[j] + prev[j + 1]
+		- next[j - 1] - 2 * next[j] - next[j + 1];
+	      const int gx = prev[j - 1] + 2 * cur[j - 1] + next[j - 1]
+		- prev[j + 1] - 2 * cur[j + 1] - next[j + 1];
 
-	      s.max = opt::at(hough.acc(), i, j);
-	      s.pos = j;
+	      if (gy == 0 || 10000 * std::abs(gx) > tan_max * std::abs(gy))
+		continue;
 
-	      q.pop();
-	      q.push(s);
+	      skew_voter v;
+	      v.x = j - half_ncols;
+	      v.y = i - half_nrows;
+	      voters_t.push_back(v);
 	    }
 	  }
+
+#  ifdef _OPENMP
+#   pragma omp critical (scribo_preprocessing_skew_voters)
+#  endif // ! _OPENMP
+	  voters.insert(voters.end(), voters_t.begin(), voters_t.end());
 	}
+      }
 
-	while (!q.empty())
-	{
-	  hist[q.top().pos] += q.top().max;
-	  h_value = hist[q.top().pos];
 
-	  if (h_value > max)
-	  {
-	    max = h_value;
-	    pos = q.top().pos;
-	  }
+      /*! \brief Vote for the skew angles \p first, \p first + \p
+	step, ... up to \p last and return the best one.
 
-	  q.pop();
+	The voters are shared among \p nthreads accumulators.
+       */
+      inline
+      int
+      skew_best_angle(const skew_lut& lut, unsigned max_rho,
+		      const std::vector<skew_voter>& voters,
+		      int first, int last, int step, double& confidence,
+		      unsigned nthreads)
+      {
+	skew_hough hough(lut, max_rho, first, last, step);
+	const int nvoters = voters.size();
+
+#  ifdef _OPENMP
+#   pragma omp parallel num_threads(nthreads)
+#  else
+	(void) nthreads;
+#  endif // ! _OPENMP
+	{
+	  skew_hough hough_t(lut, max_rho, first, last, step);
+
+#  ifdef _OPENMP
+#   pragma omp for schedule(static)
+#  endif // ! _OPENMP
+	  for (int i = 0; i < nvoters; ++i)
+	    hough_t.vote(voters[i]);
+
+#  ifdef _OPENMP
+#   pragma omp critical (scribo_preprocessing_skew_best_angle)
+#  endif // ! _OPENMP
+	  hough.merge(hough_t);
 	}
 
-	return pos;
+	return hough.best_angle(confidence);
       }
 
 
+      /*! \brief Compute the skew angle of \p gray, in degrees.
+
+	The votes are computed on a subsampled image, first every half
+	degree and then every tenth of degree around the best angle.
+	\p confidence is the one of the first search.
+       */
       inline
       double
-      perform_deskew(const image2d<value::int_u8>& gray)
+      perform_deskew(const image2d<value::int_u8>& gray,
+		     double& confidence, unsigned nthreads)
       {
-	Hough hough(gray.ncols(), gray.nrows());
-	std::priority_queue<s_angle, std::vector<s_angle>, QCompare> q;
-	int hist[500];
-	int nb_elm = 0;
-
-	for (unsigned i = 0; i < gray.nrows() - 1; ++i)
-	{
-	  for (unsigned j = 1; j < gray.ncols() - 1; ++j)
-	  {
-	    unsigned up = 1;
-	    unsigned down = 1;
-	    unsigned mean = ((opt::at(gray, i, j) * opt::at(gray, i + 1, j))) >> 8;
-
-	    for (unsigned k = j - 1; k <= j + 1; ++k)
-	    {
-	      up *= opt::at(gray, i, k);
-	      down *= opt::at(gray, i + 1, k);
-	    }
+	const unsigned
+	  max_length = 1024,
+	  f = std::max(gray.nrows(), gray.ncols()) / max_length + 1;
+
+	std::vector<skew_voter> voters;
+	if (f > 1)
+	  skew_voters(skew_subsample(gray, f, nthreads), voters, nthreads);
+	else
+	  skew_voters(gray, voters, nthreads);
+
+	confidence = 0;
+	if (voters.empty())
+	  return 0;
+
+	const unsigned
+	  nrows = gray.nrows() / f,
+	  ncols = gray.ncols() / f,
+	  max_rho = unsigned(std::sqrt(double(nrows * nrows + ncols * ncols))
+			     / 2) + 2;
+	const int max = skew_lut::max_angle;
+
+	skew_lut lut;
+	double fine_confidence;
+	int angle = skew_best_angle(lut, max_rho, voters,
+				    -max, max, 5, confidence, nthreads);
+	angle = skew_best_angle(lut, max_rho, voters,
+				std::max(angle - 5, -max),
+				std::min(angle + 5, max), 1,
+				fine_confidence, nthreads);
+
+	return angle / 10.;
+      }
 
-	    up = 255 - (up >>  16);
-	    down = down >> 16;
 
-	    if (up > down && down > mean && down > 130)
-	    {
-
-	      ++nb_elm;
-	      double gy = opt::at(gray, i - 1, j - 1) + 2 * opt::at(gray, i - 1, j) +
-		opt::at(gray, i - 1, j + 1);
-	      gy += -opt::at(gray, i + 1, j - 1) - 2 * opt::at(gray, i + 1, j) -
-		opt::at(gray, i + 1, j + 1);
-
-	      double gx = opt::at(gray, i - 1, j - 1) + 2 * opt::at(gray, i, j - 1) +
-		opt::at(gray, i + 1, j - 1);
-	      gx += -opt::at(gray, i - 1, j + 1) - 2 * opt::at(gray, i, j + 1) -
-		opt::at(gray, i + 1, j + 1);
-
-	      double tanv = (PI / 2.0 - atan(gy / gx)) * 180.0 / PI;
-
-	      if (tanv <= 25.0 || tanv >= 155.0)
-	      {
-		++nb_elm;
-		vote(j, i, hough, int((tanv <= 25.0 ? 250.0 - tanv * 10.0 :
-				       (180.0 - tanv) * 10.0 + 250.0)));
-	      }
-	    }
-	  }
-	}
+      inline
+      double
+      perform_deskew(const image2d<value::int_u8>& gray)
+      {
+	double confidence;
+	return perform_deskew(gray, confidence, 1);
+      }
 
-	init_hist(hough, hist, q, nb_elm);
 
-	return 90 - (get_max(hough, hist, q, nb_elm) + 650) / 10;
+      /// Rotate \p input by \p angle degrees.
+      template <typename I>
+      inline
+      mln_concrete(I)
+      deskew_rotate(const I& input, double angle, unsigned)
+      {
+	return geom::rotate(input, angle,
+			    //mln_max(mln_value(I)),
+			    extend(input, mln_min(mln_value(I))),
+			    mln::make::box2d(input.nrows(), input.ncols()));
       }
 
-
+      inline
+      image2d<value::int_u8>
+      deskew_rotate(const image2d<value::int_u8>& input, double angle,
+		    unsigned nthreads)
+      {
+	return rotate_shear(input, angle, mln_min(value::int_u8), nthreads);
+      }
 
     } // end of namespace scribo::preprocessing::internal
 
 
 
     template <typename I>
-    mln_concrete(I)
-    deskew(const Image<I>& input_gl_)
+    double
+    skew_angle(const Image<I>& input_gl_, double& confidence,
+	       unsigned nthreads)
     {
       const I& input_gl = exact(input_gl_);
 
-      trace::entering("scribo::preprocessing::deskew");
+      trace::entering("scribo::preprocessing::skew_angle");
       mln_assertion(input_gl.is_valid());
       mlc_is(mln_domain(I), box2d)::check();
       mlc_is_not(mln_value(I), bool)::check();
       mlc_is_not_a(mln_value(I), value::Vectorial)::check();
 
-      double angle = internal::perform_deskew(input_gl);
-//      std::cout << angle << std::endl;
+      double angle = internal::perform_deskew(input_gl, confidence, nthreads);
 
-      mln_concrete(I) output = input_gl;
+      trace::exiting("scribo::preprocessing::skew_angle");
+      return angle;
+    }
 
-      // FIXME: trick to make this routine faster for really small
-      // angles (no impact on the results)
-      if (angle > 0.5 || angle < -0.5)
-	output = geom::rotate(input_gl, - angle,
-			      //mln_max(mln_value(I)),
-			      extend(input_gl, mln_min(mln_value(I))),
-			      mln::make::box2d(input_gl.nrows(),
-					       input_gl.ncols()));
+
+    template <typename I>
+    mln_concrete(I)
+    deskew(const Image<I>& input_gl_, double min_angle, unsigned nthreads,
+	   double& angle, double& confidence)
+    {
+      const I& input_gl = exact(input_gl_);
+
+      trace::entering("scribo::preprocessing::deskew");
+
+      angle = skew_angle(input_gl, confidence, nthreads);
+
+      mln_concrete(I) output = input_gl;
+      if (angle > min_angle || angle < - min_angle)
+	output = internal::deskew_rotate(input_gl, - angle, nthreads);
 
       trace::exiting("scribo::preprocessing::deskew");
       return output;
     }
 
 
+    template <typename I>
+    mln_concrete(I)
+    deskew(const Image<I>& input_gl)
+    {
+      bool rotated;
+      return deskew(input_gl, rotated);
+    }
+
+
+    template <typename I>
+    mln_concrete(I)
+    deskew(const Image<I>& input_gl, bool& rotated)
+    {
+      // Really small angles have no impact on the results.
+      const double min_angle = 0.5;
+
+      double angle, confidence;
+      mln_concrete(I) output = deskew(input_gl, min_angle, 1,
+				      angle, confidence);
+      rotated = angle > min_angle || angle < - min_angle;
+      return output;
+    }
+
+
 # endif // ! MLN_INCLUDE_ONLY
 
 
@@ -0,0 +1,298 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+#ifndef SCRIBO_PREPROCESSING_ROTATE_SHEAR_HH
+# define SCRIBO_PREPROCESSING_ROTATE_SHEAR_HH
+
+/// \file
+///
+/// Fast rotation of gray level images by three shears.
+
+# include <cmath>
+# include <vector>
+# include <algorithm>
+
+# include <mln/core/image/image2d.hh>
+# include <mln/core/alias/box2d.hh>
+# include <mln/core/alias/dpoint2d.hh>
+# include <mln/math/pi.hh>
+# include <mln/value/int_u8.hh>
+
+
+namespace scribo
+{
+
+  namespace preprocessing
+  {
+
+    using namespace mln;
+
+    /*! \brief Rotate a gray level image around its center.
+
+      \param[in] input      A gray level image.
+      \param[in] angle      An angle in degrees, in ]-90, 90[.
+      \param[in] background The value of the sites which were not
+                            part of \p input before the rotation.
+      \param[in] nthreads   The number of threads used if OpenMP
+                            is available.
+
+      \return An image with the same domain as \p input.
+
+      The rotation is the composition of a horizontal, a vertical
+      and a horizontal shear. Each shear translates the rows or the
+      columns with a linear interpolation, which is much faster than
+      the per-site transformation of geom::rotate. The angle has the
+      same meaning as in geom::rotate.
+     */
+    image2d<value::int_u8>
+    rotate_shear(const image2d<value::int_u8>& input, double angle,
+		 value::int_u8 background, unsigned nthreads);
+
+    /// \overload
+    /// The rotation is computed on a single thread.
+    //
+    image2d<value::int_u8>
+    rotate_shear(const image2d<value::int_u8>& input, double angle,
+		 value::int_u8 background);
+
+
+
+# ifndef MLN_INCLUDE_ONLY
+
+    namespace internal
+    {
+
+      /// Blend \p v and \p u with the weights 256 - \p w and \p w.
+      inline
+      unsigned char
+      shear_blend(unsigned v, unsigned u, unsigned w)
+      {
+	return (v * (256 - w) + u * w + 128) >> 8;
+      }
+
+
+      /*! \brief Translate a row by \p shift.
+
+	Set out[i] to in[first + i - shift] for i in [0, \p n), with
+	a linear interpolation. The values out of [0, \p in_n) are
+	\p bg.
+       */
+      inline
+      void
+      shear_row(const value::int_u8* in_, int in_n,
+		value::int_u8* out_, int first, int n,
+		double shift, unsigned char bg)
+      {
+	mln_precondition(sizeof(value::int_u8) == 1);
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(in_);
+	unsigned char* out = reinterpret_cast<unsigned char*>(out_);
+
+	int k = int(std::floor(shift));
+	unsigned w = unsigned((shift - k) * 256 + 0.5);
+	if (w == 256)
+	{
+	  ++k;
+	  w = 0;
+	}
+
+	// in[src] and in[src - 1] are blended, src being src0 + i.
+	const int
+	  src0 = first - k,
+	  begin = std::min(std::max(1 - src0, 0), n),
+	  end = std::max(std::min(in_n - src0, n), begin);
+
+	int i = 0;
+	for (; i < begin; ++i)
+	{
+	  const int src = src0 + i;
+	  out[i] = shear_blend(src >= 0 && src < in_n ? in[src] : bg,
+			       src >= 1 && src <= in_n ? in[src - 1] : bg,
+			       w);
+	}
+
+	const unsigned char* p = in + src0;
+	for (; i < end; ++i)
+	  out[i] = (p[i] * (256 - w) + p[i - 1] * w + 128) >> 8;
+
+	for (; i < n; ++i)
+	{
+	  const int src = src0 + i;
+	  out[i] = shear_blend(src >= 0 && src < in_n ? in[src] : bg,
+			       src >= 1 && src <= in_n ? in[src - 1] : bg,
+			       w);
+	}
+      }
+
+
+      /*! \brief Translate each column of \p input.
+
+	Set output(row, col) to input(row - slope * (col - center), col)
+	for the sites of \p output, with a linear interpolation. \p input must
+	contain all the rows used.
+       */
+      inline
+      void
+      shear_columns(const image2d<value::int_u8>& input,
+		    image2d<value::int_u8>& output,
+		    double slope, int center, unsigned nthreads)
+      {
+	const int
+	  nrows = output.nrows(),
+	  ncols = output.ncols(),
+	  min_row = output.domain().pmin().row(),
+	  min_col = output.domain().pmin().col();
+
+	std::vector<int> k(ncols);
+	std::vector<unsigned> w(ncols);
+	for (int col = 0; col < ncols; ++col)
+	{
+	  const double shift = slope * (min_col + col - center);
+	  k[col] = int(std::floor(shift));
+	  w[col] = unsigned((shift - k[col]) * 256 + 0.5);
+	  if (w[col] == 256)
+	  {
+	    ++k[col];
+	    w[col] = 0;
+	  }
+	}
+
+	const int stride = input.delta_index(dpoint2d(1, 0));
+
+#  ifdef _OPENMP
+#   pragma omp parallel for num_threads(nthreads) schedule(static)
+#  else
+	(void) nthreads;
+#  endif // ! _OPENMP
+	for (int row = 0; row < nrows; ++row)
+	{
+	  const unsigned char* in =
+	    reinterpret_cast<const unsigned char*>(&input.at_(min_row + row,
+							      min_col));
+	  unsigned char* out =
+	    reinterpret_cast<unsigned char*>(&output.at_(min_row + row,
+							 min_col));
+
+	  for (int col = 0; col < ncols; ++col)
+	  {
+	    const unsigned char* p = in + col - k[col] * stride;
+	    out[col] = shear_blend(*p, *(p - stride), w[col]);
+	  }
+	}
+      }
+
+
+      /// Translate each row of \p input by slope * (row - center).
+      inline
+      void
+      shear_rows(const image2d<value::int_u8>& input,
+		 image2d<value::int_u8>& output,
+		 double slope, int center, unsigned char bg,
+		 unsigned nthreads)
+      {
+	const box2d
+	  in_b = input.domain(),
+	  out_b = output.domain();
+	const int
+	  in_ncols = input.ncols(),
+	  ncols = output.ncols(),
+	  first = out_b.pmin().col() - in_b.pmin().col();
+
+#  ifdef _OPENMP
+#   pragma omp parallel for num_threads(nthreads) schedule(static)
+#  else
+	(void) nthreads;
+#  endif // ! _OPENMP
+	for (int row = out_b.pmin().row(); row <= out_b.pmax().row(); ++row)
+	{
+	  value::int_u8* out = &output.at_(row, out_b.pmin().col());
+
+	  if (row < in_b.pmin().row() || row > in_b.pmax().row())
+	    std::fill(out, out + ncols, value::int_u8(bg));
+	  else
+	    shear_row(&input.at_(row, in_b.pmin().col()), in_ncols,
+		      out, first, ncols, slope * (row - center), bg);
+	}
+      }
+
+    } // end of namespace scribo::preprocessing::internal
+
+
+    inline
+    image2d<value::int_u8>
+    rotate_shear(const image2d<value::int_u8>& input, double angle,
+		 value::int_u8 background, unsigned nthreads)
+    {
+      trace::entering("scribo::preprocessing::rotate_shear");
+      mln_precondition(input.is_valid());
+      mln_precondition(angle > -90 && angle < 90);
+
+      const box2d b = input.domain();
+      const point2d c = b.pcenter();
+      const double
+	theta = - angle * math::pi / 180.,
+	alpha = - std::tan(theta / 2),
+	beta = std::sin(theta);
+
+      // The first two shears need margins so that no site of the
+      // output is lost on the way.
+      const int
+	half_h = std::max(c.row() - b.pmin().row(), b.pmax().row() - c.row()),
+	half_w = std::max(c.col() - b.pmin().col(), b.pmax().col() - c.col()),
+	m1 = int(std::ceil(std::fabs(alpha) * half_h)) + 2,
+	m2 = int(std::ceil(std::fabs(beta) * (half_w + m1))) + 2;
+
+      image2d<value::int_u8>
+	sheared_x(box2d(point2d(b.pmin().row() - m2, b.pmin().col() - m1),
+			point2d(b.pmax().row() + m2, b.pmax().col() + m1))),
+	sheared_y(box2d(point2d(b.pmin().row(), b.pmin().col() - m1),
+			point2d(b.pmax().row(), b.pmax().col() + m1))),
+	output(b);
+
+      const unsigned char bg = background.to_enc();
+      internal::shear_rows(input, sheared_x, alpha, c.row(), bg, nthreads);
+      internal::shear_columns(sheared_x, sheared_y, beta, c.col(), nthreads);
+      internal::shear_rows(sheared_y, output, alpha, c.row(), bg, nthreads);
+
+      trace::exiting("scribo::preprocessing::rotate_shear");
+      return output;
+    }
+
+
+    inline
+    image2d<value::int_u8>
+    rotate_shear(const image2d<value::int_u8>& input, double angle,
+		 value::int_u8 background)
+    {
+      return rotate_shear(input, angle, background, 1);
+    }
+
+# endif // ! MLN_INCLUDE_ONLY
+
+  } // end of namespace scribo::preprocessing
+
+} // end of namespace scribo
+
+
+#endif // ! SCRIBO_PREPROCESSING_ROTATE_SHEAR_HH
@@ -33,6 +33,8 @@
 
 # include <mln/core/concept/neighborhood.hh>
 # include <mln/core/site_set/box.hh>
+# include <mln/core/image/image2d.hh>
+# include <mln/core/alias/neighb2d.hh>
 
 # include <mln/accu/shape/bbox.hh>
 # include <mln/accu/center.hh>
@@ -77,6 +79,18 @@ namespace scribo
       components(const Image<I>& input,
 		 const Neighborhood<N>& nbh, V& ncomponents);
 
+      /// \overload
+      /// 2D images are labeled with c4 and c8 on \p nthreads threads
+      /// if OpenMP is available. The result does not depend on
+      /// \p nthreads.
+      //
+      template <typename I, typename N, typename V>
+      inline
+      component_set<mln_ch_value(I,V)>
+      components(const Image<I>& input,
+		 const Neighborhood<N>& nbh, V& ncomponents,
+		 unsigned nthreads);
+
 
 # ifndef MLN_INCLUDE_ONLY
 
@@ -100,6 +114,48 @@ namespace scribo
 	}
 
 
+	template <typename I, typename N, typename V>
+	inline
+	component_set<mln_ch_value(I,V)>
+	components_dispatch(metal::false_,
+			    const Image<I>& input,
+			    const Neighborhood<N>& nbh, V& ncomponents,
+			    unsigned nthreads)
+	{
+	  typedef mln_ch_value(I,V) L;
+	  typedef mln::accu::shape::bbox<mln_site(L)> bbox_accu_t;
+	  typedef mln::accu::center<mln_site(L)> center_accu_t;
+	  typedef mln::accu::pair<bbox_accu_t, center_accu_t> pair_accu_t;
+
+	  mln::util::couple<L,
+	    mln::util::couple<mln::util::array<mln_result(pair_accu_t)>,
+	    mln::util::array<pair_accu_t> > >
+	    results = labeling::value_and_compute(input, true, nbh, ncomponents,
+						  pair_accu_t(), nthreads);
+
+	  return component_set<L>(results.first(), ncomponents,
+				  results.second().second());
+	}
+
+	template <typename I, typename N, typename V>
+	inline
+	component_set<mln_ch_value(I,V)>
+	components_dispatch(metal::true_,
+			    const Image<I>& input,
+			    const Neighborhood<N>& nbh, V& ncomponents,
+			    unsigned nthreads)
+	{
+	  typedef mln_ch_value(I,V) L;
+
+	  // The attributes are computed into arrays and copied
+	  // straight into the component infos.
+	  labeling::attributes2d attribs;
+	  L lbl = labeling::value_and_compute(exact(input), true, exact(nbh),
+					      ncomponents, attribs, nthreads);
+
+	  return component_set<L>(lbl, ncomponents, attribs);
+	}
+
       } // end of namespace scribo::primitive::extract::internal
 
 
@@ -107,34 +163,39 @@ namespace scribo
       inline
       component_set<mln_ch_value(I,V)>
       components(const Image<I>& input,
-		 const Neighborhood<N>& nbh, V& ncomponents)
+		 const Neighborhood<N>& nbh, V& ncomponents,
+		 unsigned nthreads)
       {
 	trace::entering("scribo::components");
 
 	internal::components_tests(input, nbh, ncomponents);
 
-	typedef mln_ch_value(I,V) L;
-	typedef mln::accu::shape::bbox<mln_site(L)> bbox_accu_t;
-	typedef mln::accu::center<mln_site(L)> center_accu_t;
-	typedef mln::accu::pair<bbox_accu_t, center_accu_t> pair_accu_t;
-
 	// Setting extension value.
 	extension::fill(input, 0);
 
-	mln::util::couple<L,
-	  mln::util::couple<mln::util::array<mln_result(pair_accu_t)>,
-	  mln::util::array<pair_accu_t> > >
-
-	  results = labeling::value_and_compute(input, true, nbh, ncomponents,
-						pair_accu_t());
-
-	component_set<L>
-	output(results.first(), ncomponents, results.second().second());
+	enum {
+	  test = mlc_equal(I, image2d<bool>)::value
+	  && mlc_equal(N, neighb2d)::value
+	};
+	component_set<mln_ch_value(I,V)>
+	  output = internal::components_dispatch(metal::bool_<test>(),
+						 input, nbh, ncomponents,
+						 nthreads);
 
 	trace::exiting("scribo::components");
 	return output;
       }
 
+
+      template <typename I, typename N, typename V>
+      inline
+      component_set<mln_ch_value(I,V)>
+      components(const Image<I>& input,
+		 const Neighborhood<N>& nbh, V& ncomponents)
+      {
+	return components(input, nbh, ncomponents, 1);
+      }
+
 # endif // ! MLN_INCLUDE_ONLY
 
     } // end of namespace scribo::primitive::extract
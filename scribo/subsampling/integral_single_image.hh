@@ -38,6 +38,9 @@
 #include <mln/extension/fill.hh>
 #include <mln/debug/println.hh>
 #include <mln/debug/println_with_border.hh>
+#include <mln/value/int_u8.hh>
+
+#include <scribo/core/integral_image.hh>
 
 
 
@@ -87,6 +90,26 @@ namespace scribo
 	     Image<J>& integral_sum, Image<J>& integral_sum_2);
 
 
+    /*! \overload
+
+      The integral images are computed in two integer planes, see
+      scribo::integral_image. \p input must be an 8-bit image.
+     */
+    template <typename I>
+    inline
+    mln_concrete(I)
+    integral(const Image<I>& input, unsigned scale,
+	     integral_image& integral_sum_sum_2,
+	     const mln_domain(I)& output_domain, unsigned border_thickness);
+
+    /// \overload
+    template <typename I>
+    inline
+    mln_concrete(I)
+    integral(const Image<I>& input, unsigned scale,
+	     integral_image& integral_sum_sum_2);
+
+
 
 # ifndef MLN_INCLUDE_ONLY
 
@@ -398,6 +421,144 @@ namespace scribo
       }
 
 
+      /// Compute the row \p row of \p sub and of \p integral_sum_sum_2
+      /// from the \p scale input rows starting at \p rows[0] ...
+      /// \p rows[scale - 1].
+      template <unsigned scale, typename O>
+      inline
+      void
+      integral_planes_row(const value::int_u8* const* rows, unsigned row,
+			  O& sub, integral_image& integral_sum_sum_2)
+      {
+	typedef mln_value(O) V;
+	typedef integral_image::sum_t S;
+	typedef integral_image::sum_2_t S2;
+
+	const int up = integral_sum_sum_2.delta_index(dpoint2d(-1, 0));
+	const float area = scale * scale;
+	const unsigned ncols = sub.ncols();
+
+	const value::int_u8* ptr[scale];
+	for (unsigned i = 0; i < scale; ++i)
+	  ptr[i] = rows[i];
+
+	V* p_sub = & sub.at_(row, 0);
+	S* p_sum = & integral_sum_sum_2.sum.at_(row, 0);
+	S2* p_sum_2 = & integral_sum_sum_2.sum_2.at_(row, 0);
+
+	// Sums over a block never exceed 9 * 255^2 with scale 3.
+	S h_sum = 0;
+	S2 h_sum_2 = 0;
+	for (unsigned col = 0; col < ncols; ++col)
+	{
+	  unsigned local_sum = 0, local_sum_2 = 0;
+	  for (unsigned i = 0; i < scale; ++i)
+	  {
+	    for (unsigned j = 0; j < scale; ++j)
+	    {
+	      const unsigned v = ptr[i][j];
+	      local_sum += v;
+	      local_sum_2 += v * v;
+	    }
+	    ptr[i] += scale;
+	  }
+
+	  // Same rounding as the floating point integral images.
+	  mln::convert::from_to(float(local_sum) / area, *p_sub++);
+	  h_sum += local_sum;
+	  h_sum_2 += local_sum_2;
+
+	  if (row == 0)
+	  {
+	    *p_sum = h_sum;
+	    *p_sum_2 = h_sum_2;
+	  }
+	  else
+	  {
+	    *p_sum = h_sum + *(p_sum + up);
+	    *p_sum_2 = h_sum_2 + *(p_sum_2 + up);
+	  }
+
+	  ++p_sum;
+	  ++p_sum_2;
+	}
+      }
+
+
+      template <typename O>
+      inline
+      void
+      integral_row(const value::int_u8* const* rows, unsigned scale,
+		   unsigned row,
+		   O& sub, integral_image& integral_sum_sum_2)
+      {
+	if (scale == 3)
+	  integral_planes_row<3>(rows, row, sub, integral_sum_sum_2);
+	else if (scale == 2)
+	  integral_planes_row<2>(rows, row, sub, integral_sum_sum_2);
+	else
+	  std::cerr << "NYI!" << std::endl;
+      }
+
+
+      template <unsigned scale, typename I>
+      inline
+      mln_concrete(I)
+      integral_planes(const I& input,
+		      integral_image& integral_sum_sum_2,
+		      const mln_domain(I)& output_domain,
+		      unsigned border_thickness)
+      {
+	trace::entering("subsampling::impl::integral_planes");
+
+	typedef mln_value(I) V;
+
+	mlc_equal(V, value::int_u8)::check();
+	mln_precondition(input.is_valid());
+	mln_precondition(input.domain().pmin() == literal::origin);
+
+	mln_concrete(I) sub(output_domain, border_thickness);
+	extension::fill(sub, 0);
+
+	integral_sum_sum_2.init_(output_domain, border_thickness);
+
+	const unsigned nrows = output_domain.nrows();
+
+	for (unsigned row = 0; row < nrows; ++row)
+	{
+	  const V* rows[scale];
+	  for (unsigned i = 0; i < scale; ++i)
+	    rows[i] = & input.at_(scale * row + i, 0);
+
+	  integral_planes_row<scale>(rows, row, sub, integral_sum_sum_2);
+	}
+
+	trace::exiting("subsampling::impl::integral_planes");
+	return sub;
+      }
+
+
+      template <typename I>
+      inline
+      mln_concrete(I)
+      integral(const Image<I>& input, unsigned scale,
+	       integral_image& integral_sum_sum_2,
+	       const mln_domain(I)& output_domain, unsigned border_thickness)
+      {
+	if (scale == 3)
+	  return integral_planes<3>(exact(input), integral_sum_sum_2,
+				    output_domain, border_thickness);
+	else if (scale == 2)
+	  return integral_planes<2>(exact(input), integral_sum_sum_2,
+				    output_domain, border_thickness);
+	else
+	  std::cerr << "NYI!" << std::endl;
+
+	typedef mln_concrete(I) output_t;
+	return output_t();
+      }
+
+
     } // end of namespace mln::subsampling::impl
 
 
@@ -453,6 +614,54 @@ namespace scribo
       return output;
     }
 
+    template <typename I>
+    inline
+    mln_concrete(I)
+    integral(const Image<I>& input_, unsigned scale,
+	     integral_image& integral_sum_sum_2,
+	     const mln_domain(I)& output_domain, unsigned border_thickness)
+    {
+      trace::entering("subsampling::integral");
+
+      const I& input = exact(input_);
+
+      mln_precondition(input.is_valid());
+      mln_precondition(input.domain().pmin() == literal::origin);
+      mln_precondition(scale > 1);
+
+      mln_concrete(I)
+	output = impl::integral(input, scale, integral_sum_sum_2,
+				output_domain, border_thickness);
+
+      trace::exiting("subsampling::integral");
+      return output;
+    }
+
+    template <typename I>
+    inline
+    mln_concrete(I)
+    integral(const Image<I>& input_, unsigned scale,
+	     integral_image& integral_sum_sum_2)
+    {
+      trace::entering("subsampling::integral");
+
+      const I& input = exact(input_);
+
+      mln_precondition(input.is_valid());
+      mln_precondition(input.domain().pmin() == literal::origin);
+      mln_precondition(scale > 1);
+
+      box<mln_site(I)>
+	b = mln::make::box2d((input.nrows() + scale - 1) / scale,
+			     (input.ncols() + scale - 1) / scale);
+      mln_concrete(I) output;
+      output = integral(input_, scale, integral_sum_sum_2,
+			b, mln::border::thickness);
+
+      trace::exiting("subsampling::integral");
+      return output;
+    }
+
 # endif // ! MLN_INCLUDE_ONLY
 
   } // end of namespace scribo::subsampling
@@ -44,5 +44,6 @@ namespace scribo
 # include <scribo/text/extract_lines.hh>
 //# include <scribo/text/recognition.hh>
 # include <scribo/text/clean.hh>
+# include <scribo/text/contains_text.hh>
 
 #endif // ! SCRIBO_TEXT_ALL_HH
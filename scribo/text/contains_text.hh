@@ -0,0 +1,256 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+#ifndef SCRIBO_TEXT_CONTAINS_TEXT_HH
+# define SCRIBO_TEXT_CONTAINS_TEXT_HH
+
+/// \file
+///
+/// \brief Cheaply estimate whether a document image contains text.
+
+# include <vector>
+# include <algorithm>
+
+# include <mln/core/concept/image.hh>
+# include <mln/core/alias/neighb2d.hh>
+# include <mln/core/image/image2d.hh>
+# include <mln/logical/not.hh>
+# include <mln/subsampling/antialiased.hh>
+# include <mln/value/int_u8.hh>
+
+# include <scribo/core/def/lbl_type.hh>
+# include <scribo/core/macros.hh>
+# include <scribo/core/component_set.hh>
+# include <scribo/binarization/sauvola.hh>
+# include <scribo/primitive/extract/components.hh>
+
+
+namespace scribo
+{
+
+  namespace text
+  {
+
+    using namespace mln;
+
+    /*! \brief Cheaply estimate whether a document image contains text.
+
+      The image is subsampled so that its largest side is at most
+      \p max_size pixels, binarized and labeled, in both
+      polarities. Character-like components are then chained with
+      their horizontally aligned neighbors and the chains are
+      checked with the criteria of look_like_text_lines.
+
+      This is meant to skip the full text extraction chain on
+      pictures. False negatives are possible, mainly for small
+      text: increasing \p max_size or decreasing \p
+      min_text_components trades speed for recall.
+
+      \param[in] input A gray level image.
+      \param[in] max_size The largest side of the subsampled image.
+      \param[in] min_text_components The minimum number of
+      components in text-like chains.
+
+      \return false if the image is unlikely to contain text.
+    */
+    template <typename I>
+    bool
+    contains_text(const Image<I>& input, unsigned max_size,
+		  unsigned min_text_components);
+
+    /// \overload
+    /// \p max_size is set to 512 and \p min_text_components to 6.
+    //
+    template <typename I>
+    bool
+    contains_text(const Image<I>& input);
+
+
+# ifndef MLN_INCLUDE_ONLY
+
+
+    namespace internal
+    {
+
+      /// Union-find root with path halving.
+      inline
+      unsigned
+      contains_text_find_root(std::vector<unsigned>& parent, unsigned i)
+      {
+	while (parent[i] != i)
+	  i = parent[i] = parent[parent[i]];
+	return i;
+      }
+
+
+      /// Return the number of components belonging to text-like
+      /// chains, stopping as soon as \p enough is reached.
+      ///
+      /// \p factor is the subsampling factor of the image \p comps
+      /// were extracted from.
+      //
+      template <typename L>
+      unsigned
+      count_text_components(const component_set<L>& comps,
+			    unsigned factor, unsigned enough)
+      {
+	const unsigned nrows = comps.labeled_image().domain().nrows();
+	const mln::def::coord row0 = comps.labeled_image().domain().pmin().row();
+
+	// Character-like components, bucketed by their bottom row.
+	std::vector<unsigned> chars;
+	std::vector<std::vector<unsigned> > by_bottom(nrows);
+	for_all_comps(c, comps)
+	{
+	  const box2d& b = comps(c).bbox();
+	  const unsigned h = b.height(), w = b.width();
+
+	  // Neither specks nor pictures, and words merged by the
+	  // subsampling are accepted.
+	  if (h < 2 || h > nrows / 8 || w > 8 * h || comps(c).card() < 3)
+	    continue;
+
+	  by_bottom[b.pmax().row() - row0].push_back(c);
+	  chars.push_back(c);
+	}
+
+	// Chain each component with its aligned neighbors on the
+	// right: close enough, sharing the same bottom line and of
+	// similar height.
+	const unsigned ncomps = unsigned(comps.nelements()) + 1;
+	std::vector<unsigned> parent(ncomps);
+	for (unsigned i = 0; i < ncomps; ++i)
+	  parent[i] = i;
+
+	for (unsigned i = 0; i < chars.size(); ++i)
+	{
+	  const box2d& b = comps(chars[i]).bbox();
+	  const int h = b.height();
+	  const int
+	    bottom = b.pmax().row() - row0,
+	    rmin = std::max(0, bottom - h / 3),
+	    rmax = std::min(int(nrows) - 1, bottom + h / 3);
+
+	  for (int r = rmin; r <= rmax; ++r)
+	    for (unsigned j = 0; j < by_bottom[r].size(); ++j)
+	    {
+	      const box2d& n = comps(by_bottom[r][j]).bbox();
+	      const int
+		hn = n.height(),
+		gap = n.pmin().col() - b.pmax().col();
+
+	      if (gap > 0 && gap <= std::max(2, h)
+		  && std::max(h, hn) <= 2 * std::min(h, hn))
+		parent[contains_text_find_root(parent, chars[i])]
+		  = contains_text_find_root(parent, by_bottom[r][j]);
+	    }
+	}
+
+	// Chain cardinality and bounding box, indexed by root.
+	std::vector<unsigned> card(ncomps, 0);
+	std::vector<box2d> bbox(ncomps);
+	for (unsigned i = 0; i < chars.size(); ++i)
+	{
+	  unsigned root = contains_text_find_root(parent, chars[i]);
+	  if (card[root]++ == 0)
+	    bbox[root] = comps(chars[i]).bbox();
+	  else
+	    bbox[root].merge(comps(chars[i]).bbox());
+	}
+
+	// Same criteria as text::internal::looks_like_a_text_line,
+	// the height being expressed in the input image.
+	unsigned count = 0;
+	for (unsigned i = 0; i < chars.size() && count < enough; ++i)
+	  if (parent[chars[i]] == chars[i]
+	      && card[chars[i]] >= 3
+	      && bbox[chars[i]].height() * factor > 10
+	      && bbox[chars[i]].width() > bbox[chars[i]].height())
+	    count += card[chars[i]];
+
+	return count;
+      }
+
+    } // end of namespace scribo::text::internal
+
+
+
+    // Facades
+
+    template <typename I>
+    bool
+    contains_text(const Image<I>& input_, unsigned max_size,
+		  unsigned min_text_components)
+    {
+      trace::entering("scribo::text::contains_text");
+
+      const I& input = exact(input_);
+      mlc_is_a(mln_value(I), value::Scalar)::check();
+      mln_precondition(input.is_valid());
+      mln_precondition(max_size > 0);
+
+      const unsigned
+	size = std::max(input.nrows(), input.ncols()),
+	factor = (size + max_size - 1) / max_size;
+
+      mln_concrete(I) small = mln::subsampling::antialiased(input, factor);
+
+      def::lbl_type ncomps;
+
+      // Text may be darker or lighter than the background.
+      mln_ch_value(I, bool) bin = scribo::binarization::sauvola(small, 31);
+      unsigned count = internal::count_text_components(
+	primitive::extract::components(bin, c8(), ncomps),
+	factor, min_text_components);
+
+      if (count < min_text_components)
+      {
+	logical::not_inplace(bin);
+	count += internal::count_text_components(
+	  primitive::extract::components(bin, c8(), ncomps),
+	  factor, min_text_components - count);
+      }
+
+      trace::exiting("scribo::text::contains_text");
+      return count >= min_text_components;
+    }
+
+
+    template <typename I>
+    bool
+    contains_text(const Image<I>& input)
+    {
+      return contains_text(input, 512, 6);
+    }
+
+
+# endif // ! MLN_INCLUDE_ONLY
+
+  } // end of namespace scribo::text
+
+} // end of namespace scribo
+
+
+#endif // ! SCRIBO_TEXT_CONTAINS_TEXT_HH
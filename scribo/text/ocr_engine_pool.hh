@@ -0,0 +1,297 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+#ifndef SCRIBO_TEXT_OCR_ENGINE_POOL_HH
+# define SCRIBO_TEXT_OCR_ENGINE_POOL_HH
+
+/// \file
+///
+/// \brief Pool of initialized Tesseract engines.
+///
+/// Initializing Tesseract loads the language data from disk and is
+/// much more expensive than recognizing a single line of text.  The
+/// pool keeps initialized engines alive so that they can be reused
+/// across lines, pages and toolchain runs.  Engines are indexed by
+/// language and page segmentation mode.
+///
+/// This pool is only available with Tesseract 3: Tesseract 2 has a
+/// single global engine.
+
+# include <map>
+# include <vector>
+# include <string>
+# include <iostream>
+# include <cstdlib>
+
+# include <tesseract/baseapi.h>
+
+# include <scribo/core/internal/mutex.hh>
+
+
+namespace scribo
+{
+
+  namespace text
+  {
+
+    /// \brief Thread-safe pool of initialized Tesseract engines.
+    ///
+    /// An engine returned by acquire() is owned by the caller until
+    /// it is given back with release().  Most users should rely on
+    /// scribo::text::ocr_engine instead.
+    //
+    class ocr_engine_pool
+    {
+    public:
+      ocr_engine_pool();
+      ~ocr_engine_pool();
+
+      /// Return the process-wide pool.
+      ///
+      /// It is never destroyed: engines must not outlive Tesseract's
+      /// own global data at exit. Call clear() to release the engines
+      /// explicitly.
+      static ocr_engine_pool& global();
+
+      /// Return an engine initialized for \p language and \p mode.
+      /// An idle engine is reused if there is any.
+      tesseract::TessBaseAPI*
+      acquire(const std::string& language, tesseract::PageSegMode mode);
+
+      /// Give back an engine returned by acquire() with the same
+      /// \p language and \p mode.
+      void release(tesseract::TessBaseAPI* engine,
+		   const std::string& language, tesseract::PageSegMode mode);
+
+      /// Maximum number of idle engines kept per language and mode.
+      /// Engines released beyond this limit are destroyed.
+      /// @{
+      void set_max_idle(unsigned n);
+      unsigned max_idle() const;
+      /// @}
+
+      /// Number of idle engines currently kept.
+      unsigned nidle() const;
+
+      /// Destroy all the idle engines.
+      void clear();
+
+    private:
+      // Not copyable.
+      ocr_engine_pool(const ocr_engine_pool&);
+      ocr_engine_pool& operator=(const ocr_engine_pool&);
+
+      typedef std::pair<std::string, int> key_t;
+      typedef std::vector<tesseract::TessBaseAPI*> engines_t;
+      typedef std::map<key_t, engines_t> idle_t;
+
+      idle_t idle_;
+      unsigned max_idle_;
+      mutable internal::mutex mutex_;
+    };
+
+
+    /// \brief Engine borrowed from an ocr_engine_pool for the
+    /// lifetime of this object.
+    //
+    class ocr_engine
+    {
+    public:
+      ocr_engine(const std::string& language,
+		 tesseract::PageSegMode mode = tesseract::PSM_SINGLE_LINE,
+		 ocr_engine_pool& pool = ocr_engine_pool::global());
+      ~ocr_engine();
+
+      /// Return the underlying Tesseract engine.
+      tesseract::TessBaseAPI& api();
+
+    private:
+      // Not copyable.
+      ocr_engine(const ocr_engine&);
+      ocr_engine& operator=(const ocr_engine&);
+
+      ocr_engine_pool& pool_;
+      std::string language_;
+      tesseract::PageSegMode mode_;
+      tesseract::TessBaseAPI* api_;
+    };
+
+
+# ifndef MLN_INCLUDE_ONLY
+
+
+    // ocr_engine_pool
+
+    inline
+    ocr_engine_pool::ocr_engine_pool()
+      : max_idle_(16)
+    {
+    }
+
+    inline
+    ocr_engine_pool::~ocr_engine_pool()
+    {
+      clear();
+    }
+
+    inline
+    ocr_engine_pool&
+    ocr_engine_pool::global()
+    {
+      static ocr_engine_pool* pool = new ocr_engine_pool();
+      return *pool;
+    }
+
+    inline
+    tesseract::TessBaseAPI*
+    ocr_engine_pool::acquire(const std::string& language,
+			     tesseract::PageSegMode mode)
+    {
+      {
+	internal::scoped_lock lock(mutex_);
+	engines_t& engines = idle_[key_t(language, mode)];
+	if (!engines.empty())
+	{
+	  tesseract::TessBaseAPI* engine = engines.back();
+	  engines.pop_back();
+	  return engine;
+	}
+      }
+
+      // Initialization is slow: do not hold the lock meanwhile.
+      tesseract::TessBaseAPI* engine = new tesseract::TessBaseAPI();
+      if (engine->Init(NULL, language.c_str(), NULL, 0, false) == -1)
+      {
+	std::cout << "Error: cannot initialize tesseract!" << std::endl;
+	abort();
+      }
+      engine->SetPageSegMode(mode);
+
+      return engine;
+    }
+
+    inline
+    void
+    ocr_engine_pool::release(tesseract::TessBaseAPI* engine,
+			     const std::string& language,
+			     tesseract::PageSegMode mode)
+    {
+      // Free the image and the recognition results.
+      engine->Clear();
+
+      {
+	internal::scoped_lock lock(mutex_);
+	engines_t& engines = idle_[key_t(language, mode)];
+	if (engines.size() < max_idle_)
+	{
+	  engines.push_back(engine);
+	  return;
+	}
+      }
+
+      engine->End();
+      delete engine;
+    }
+
+    inline
+    void
+    ocr_engine_pool::set_max_idle(unsigned n)
+    {
+      internal::scoped_lock lock(mutex_);
+      max_idle_ = n;
+    }
+
+    inline
+    unsigned
+    ocr_engine_pool::max_idle() const
+    {
+      internal::scoped_lock lock(mutex_);
+      return max_idle_;
+    }
+
+    inline
+    unsigned
+    ocr_engine_pool::nidle() const
+    {
+      internal::scoped_lock lock(mutex_);
+      unsigned n = 0;
+      for (idle_t::const_iterator it = idle_.begin(); it != idle_.end(); ++it)
+	n += it->second.size();
+      return n;
+    }
+
+    inline
+    void
+    ocr_engine_pool::clear()
+    {
+      idle_t engines;
+      {
+	internal::scoped_lock lock(mutex_);
+	engines.swap(idle_);
+      }
+
+      for (idle_t::iterator it = engines.begin(); it != engines.end(); ++it)
+	for (unsigned i = 0; i < it->second.size(); ++i)
+	{
+	  it->second[i]->End();
+	  delete it->second[i];
+	}
+    }
+
+
+    // ocr_engine
+
+    inline
+    ocr_engine::ocr_engine(const std::string& language,
+			   tesseract::PageSegMode mode,
+			   ocr_engine_pool& pool)
+      : pool_(pool),
+	language_(language),
+	mode_(mode),
+	api_(pool.acquire(language, mode))
+    {
+    }
+
+    inline
+    ocr_engine::~ocr_engine()
+    {
+      pool_.release(api_, language_, mode_);
+    }
+
+    inline
+    tesseract::TessBaseAPI&
+    ocr_engine::api()
+    {
+      return *api_;
+    }
+
+
+# endif // ! MLN_INCLUDE_ONLY
+
+  } // end of namespace scribo::text
+
+} // end of namespace scribo
+
+#endif // ! SCRIBO_TEXT_OCR_ENGINE_POOL_HH
@@ -35,6 +35,8 @@
 /// \todo Do not store the result in an image?
 
 # include <ostream>
+# include <vector>
+# include <string>
 
 # include <mln/core/image/dmorph/image_if.hh>
 # include <mln/core/concept/neighborhood.hh>
@@ -56,6 +58,9 @@
 # include <scribo/text/clean_inplace.hh>
 
 # include <scribo/core/line_set.hh>
+# include <scribo/core/cancellation_token.hh>
+
+# include <scribo/text/recognition_observer.hh>
 
 
 # include <tesseract/baseapi.h>
@@ -65,6 +70,10 @@
 #  define HAVE_TESSERACT_2
 # endif
 
+# ifdef HAVE_TESSERACT_3
+#  include <scribo/text/ocr_engine_pool.hh>
+# endif
+
 
 
 namespace scribo
@@ -77,6 +86,10 @@ namespace scribo
 
     /// Passes the text bboxes to Tesseract (OCR).
     ///
+    /// With Tesseract 3, the engine is taken from
+    /// scribo::text::ocr_engine_pool::global() and given back
+    /// afterwards, so that the language data is loaded only once.
+    ///
     /// \param[in] lines       The lines of text.
     /// \param[in] language    The language which should be recognized by
     ///		               Tesseract. (fra, en, ...)
@@ -88,6 +101,40 @@ namespace scribo
     recognition(line_set<L>& lines, const char *language);
 
 
+    /// Passes the text bboxes to Tesseract (OCR) using several
+    /// threads.
+    ///
+    /// Text lines are independent: they are dispatched to \p nthreads
+    /// workers, each one borrowing its own engine from
+    /// scribo::text::ocr_engine_pool::global().  The recognized text
+    /// is stored with line_info::update_text() once all the workers
+    /// are done, in line order, so that the result is identical to
+    /// the serial version.
+    ///
+    /// Lines are recognized serially if Tesseract 3 and OpenMP are
+    /// not both available or if \p nthreads is lower than 2.
+    ///
+    /// If \p cancellation is set, it is checked before each line: once
+    /// it is canceled, the remaining lines are skipped and the lines
+    /// already recognized keep their text.
+    ///
+    /// If \p observer is set, it is notified of each line as soon as
+    /// it is recognized, before the line set is updated.
+    ///
+    /// \param[in] lines        The lines of text.
+    /// \param[in] language     The language which should be recognized by
+    ///		                Tesseract. (fra, en, ...)
+    /// \param[in] nthreads     The number of workers.
+    /// \param[in] cancellation An optional cancellation token.
+    /// \param[in] observer     An optional observer.
+    //
+    template <typename L>
+    void
+    recognition(line_set<L>& lines, const char *language, unsigned nthreads,
+		const cancellation_token* cancellation = 0,
+		recognition_observer* observer = 0);
+
+
     /// Recognize text from an image.
     template <typename I>
     void
@@ -100,35 +147,30 @@ namespace scribo
 # ifndef MLN_INCLUDE_ONLY
 
 
-    template <typename L>
-    void
-    recognition(line_set<L>& lines, const char *language)
+    namespace internal
     {
-      trace::entering("scribo::text::recognition");
 
-
-      // Initialize Tesseract.
-#  ifdef HAVE_TESSERACT_2
-      TessBaseAPI::InitWithLanguage(NULL, NULL, language, NULL, false, 0, NULL);
-#  else // HAVE_TESSERACT_3
-      tesseract::TessBaseAPI tess;
-      if (tess.Init(NULL, language, NULL, 0, false) == -1)
+      /// Return true if line \p i must be passed to the OCR.
+      template <typename L>
+      inline
+      bool
+      is_recognizable(const line_set<L>& lines, unsigned i)
       {
-	std::cout << "Error: cannot initialize tesseract!" << std::endl;
-	abort();
+	return lines(i).is_valid()
+	  && ! lines(i).is_hidden()
+	  && lines(i).type() == line::Text;
       }
-      tess.SetPageSegMode(tesseract::PSM_SINGLE_LINE);
 
-#  endif // HAVE_TESSERACT_2
 
-      typedef mln_ch_value(L,bool) I;
-
-
-      /// Use text bboxes with Tesseract
-      for_all_lines(i, lines)
+      /// Build the image of line \p i, as expected by the OCR.
+      ///
+      /// Only read shared data: it may be called concurrently on
+      /// different lines.
+      template <typename L>
+      mln_ch_value(L,bool)
+      line_image(const line_set<L>& lines, unsigned i)
       {
-	if (! lines(i).is_valid() || lines(i).is_hidden() || lines(i).type() != line::Text)
-	  continue;
+	typedef mln_ch_value(L,bool) I;
 
 	mln_domain(I) box = lines(i).bbox();
 
@@ -169,6 +211,21 @@ namespace scribo
 	data::fill(line_image, false);
 	data::paste_without_localization(text_ima, line_image);
 
+	return line_image;
+      }
+
+
+      /// Recognize characters in \p line_image. Return false if the
+      /// OCR did not return anything.
+      template <typename I>
+      bool
+#  ifdef HAVE_TESSERACT_2
+      recognize_line(const I& line_image, std::string& str)
+#  else // HAVE_TESSERACT_3
+      recognize_line(tesseract::TessBaseAPI& tess, const I& line_image,
+		     std::string& str)
+#  endif // ! HAVE_TESSERACT_2
+      {
 	// Recognize characters.
 #  ifdef HAVE_TESSERACT_2
 	char* s = TessBaseAPI::TesseractRect(
@@ -189,15 +246,117 @@ namespace scribo
 	char* s = tess.GetUTF8Text();
 #  endif // ! HAVE_TESSERACT_2
 
-	if (s != 0)
-	{
-	  std::string str(s);
-	  str = str.substr(0, str.length() - 2);
-	  lines(i).update_text(str);
-	}
+	if (s == 0)
+	  return false;
+
+	str = s;
+	str = str.substr(0, str.length() - 2);
 
 	// The string has been allocated by Tesseract. It must be released.
 	delete [] s;
+
+	return true;
+      }
+
+    } // end of namespace scribo::text::internal
+
+
+
+    template <typename L>
+    void
+    recognition(line_set<L>& lines, const char *language)
+    {
+      recognition(lines, language, 1);
+    }
+
+
+    template <typename L>
+    void
+    recognition(line_set<L>& lines, const char *language, unsigned nthreads,
+		const cancellation_token* cancellation,
+		recognition_observer* observer)
+    {
+      trace::entering("scribo::text::recognition");
+
+#  if defined HAVE_TESSERACT_3 && defined _OPENMP
+      if (nthreads > 1)
+      {
+	const line_set<L>& clines = lines;
+
+	std::vector<unsigned> ids;
+	for_all_lines(i, lines)
+	  if (internal::is_recognizable(clines, i))
+	    ids.push_back(i);
+
+	const int n = ids.size();
+	std::vector<std::string> texts(n);
+	std::vector<char> found(n, 0);
+
+#   pragma omp parallel num_threads(nthreads)
+	{
+	  // One engine per worker.
+	  ocr_engine engine(language, tesseract::PSM_SINGLE_LINE);
+
+#   pragma omp for schedule(dynamic)
+	  for (int k = 0; k < n; ++k)
+	    if (cancellation == 0 || ! cancellation->is_canceled())
+	    {
+	      found[k] = internal::recognize_line(engine.api(),
+						  internal::line_image(clines, ids[k]),
+						  texts[k]);
+
+	      if (observer != 0 && found[k] && ! texts[k].empty())
+	      {
+#   pragma omp critical (scribo_text_recognition_observer)
+		observer->on_line_recognized(texts[k], clines(ids[k]).bbox());
+	      }
+	    }
+	}
+
+	// Store the results in line order.
+	for (int k = 0; k < n; ++k)
+	  if (found[k])
+	    lines(ids[k]).update_text(texts[k]);
+
+	trace::exiting("scribo::text::recognition");
+	return;
+      }
+#  else
+      (void) nthreads;
+#  endif // ! HAVE_TESSERACT_3 || ! _OPENMP
+
+
+      // Initialize Tesseract.
+#  ifdef HAVE_TESSERACT_2
+      TessBaseAPI::InitWithLanguage(NULL, NULL, language, NULL, false, 0, NULL);
+#  else // HAVE_TESSERACT_3
+      // Reuse an engine already initialized for this language.
+      ocr_engine engine(language, tesseract::PSM_SINGLE_LINE);
+      tesseract::TessBaseAPI& tess = engine.api();
+#  endif // HAVE_TESSERACT_2
+
+
+      /// Use text bboxes with Tesseract
+      for_all_lines(i, lines)
+      {
+	if (cancellation != 0 && cancellation->is_canceled())
+	  break;
+
+	if (! internal::is_recognizable(lines, i))
+	  continue;
+
+	std::string str;
+#  ifdef HAVE_TESSERACT_2
+	if (internal::recognize_line(internal::line_image(lines, i), str))
+#  else // HAVE_TESSERACT_3
+	if (internal::recognize_line(tess, internal::line_image(lines, i), str))
+#  endif // ! HAVE_TESSERACT_2
+	{
+	  if (observer != 0 && ! str.empty())
+	    observer->on_line_recognized(str, lines(i).bbox());
+
+	  lines(i).update_text(str);
+	}
       }
 
       trace::exiting("scribo::text::recognition");
@@ -219,12 +378,9 @@ namespace scribo
 #  ifdef HAVE_TESSERACT_2
       TessBaseAPI::InitWithLanguage(NULL, NULL, language, NULL, false, 0, NULL);
 #  else // HAVE_TESSERACT_3
-      tesseract::TessBaseAPI tess;
-      if (tess.Init(NULL, language, NULL, 0, false) == -1)
-      {
-	std::cout << "Error: cannot initialize tesseract!" << std::endl;
-	abort();
-      }
+      // Reuse an engine already initialized for this language.
+      ocr_engine engine(language, tesseract::PSM_SINGLE_BLOCK);
+      tesseract::TessBaseAPI& tess = engine.api();
 #  endif // ! HAVE_TESSERACT_2
 
       std::ofstream file;
@@ -0,0 +1,76 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+#ifndef SCRIBO_TEXT_RECOGNITION_OBSERVER_HH
+# define SCRIBO_TEXT_RECOGNITION_OBSERVER_HH
+
+/// \file
+///
+/// \brief Interface notified of each text line recognized by
+/// scribo::text::recognition.
+
+# include <string>
+
+# include <mln/core/alias/box2d.hh>
+
+
+namespace scribo
+{
+
+  namespace text
+  {
+
+    /// \brief Receive the text lines as soon as they are recognized.
+    ///
+    /// Lines are notified in line order by the serial recognition.
+    /// With several threads, they are notified in completion order,
+    /// one at a time.
+    //
+    class recognition_observer
+    {
+    public:
+      virtual ~recognition_observer();
+
+      /// Called for each line for which the OCR returned some text.
+      /// \p bbox is the line bounding box in the input image.
+      virtual void on_line_recognized(const std::string& text,
+				      const mln::box2d& bbox) = 0;
+    };
+
+
+# ifndef MLN_INCLUDE_ONLY
+
+    inline
+    recognition_observer::~recognition_observer()
+    {
+    }
+
+# endif // ! MLN_INCLUDE_ONLY
+
+  } // end of namespace scribo::text
+
+} // end of namespace scribo
+
+#endif // ! SCRIBO_TEXT_RECOGNITION_OBSERVER_HH
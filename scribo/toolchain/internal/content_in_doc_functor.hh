@@ -121,6 +121,14 @@ namespace scribo
 	//============
 
 	std::string ocr_language;
+
+	/// Number of threads used to recognize text lines.
+	unsigned ocr_nthreads;
+
+	/// If set, notified of each text line as soon as it is
+	/// recognized.
+	text::recognition_observer* ocr_observer;
+
 	std::string output_file;
 
 	//=========
@@ -141,6 +149,8 @@ namespace scribo
 	  save_doc_as_xml(false),
 	  allow_xml_extensions(true),
 	  ocr_language("eng"),
+	  ocr_nthreads(1),
+	  ocr_observer(0),
 	  output_file("/tmp/foo.xml"),
 	  doc(doc_filename)
       {
@@ -371,7 +381,8 @@ namespace scribo
 
 	// Text recognition
 	on_new_progress_label("Recognizing text");
-	scribo::text::recognition(lines, ocr_language.c_str());
+	scribo::text::recognition(lines, ocr_language.c_str(), ocr_nthreads,
+				  cancellation, ocr_observer);
 
 	on_progress();
 
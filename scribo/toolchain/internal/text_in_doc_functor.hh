@@ -105,6 +105,16 @@ namespace scribo
 
 	std::string ocr_language;
 
+	/// Number of threads used to extract the components.
+	unsigned components_nthreads;
+
+	/// Number of threads used to recognize text lines.
+	unsigned ocr_nthreads;
+
+	/// If set, notified of each text line as soon as it is
+	/// recognized.
+	text::recognition_observer* ocr_observer;
+
 
 	// Results
 	line_set<L> output;
@@ -119,7 +129,10 @@ namespace scribo
 	  enable_line_seps(true),
 	  enable_whitespace_seps(true),
 	  enable_debug(false),
-	  ocr_language("eng")
+	  ocr_language("eng"),
+	  components_nthreads(1),
+	  ocr_nthreads(1),
+	  ocr_observer(0)
       {
       }
 
@@ -200,7 +213,8 @@ namespace scribo
 	V ncomponents;
 	component_set<L>
 	  components = scribo::primitive::extract::components(input_cleaned, c8(),
-							      ncomponents);
+							      ncomponents,
+							      components_nthreads);
 
 	on_progress();
 
@@ -374,11 +388,14 @@ namespace scribo
 
 	on_new_progress_label("Recognizing text");
 
-	scribo::text::recognition(lines, ocr_language.c_str());
+	scribo::text::recognition(lines, ocr_language.c_str(), ocr_nthreads,
+				  cancellation, ocr_observer);
+
+	// Keep the lines recognized so far if canceled.
+	output = lines;
 
 	on_progress();
 
-	output = lines;
 	return output;
       }
 
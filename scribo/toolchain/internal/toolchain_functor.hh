@@ -28,6 +28,8 @@
 
 # include <iostream>
 
+# include <scribo/core/cancellation_token.hh>
+
 namespace scribo
 {
 
@@ -51,11 +53,18 @@ namespace scribo
 	// Triggers
 	//==========
 
+	/// Called after each step.
+	///
+	/// Throw scribo::canceled if \p cancellation is canceled.
+	/// Overriding implementations must call this one.
 	virtual void on_progress();
 	virtual void on_new_progress_label(const char *label);
 
 	// Attributes
 	bool verbose;
+
+	/// If set, checked by on_progress() and while recognizing text.
+	const cancellation_token* cancellation;
       };
 
 
@@ -63,7 +72,8 @@ namespace scribo
 
       inline
       Toolchain_Functor::Toolchain_Functor()
-	: verbose(true)
+	: verbose(true),
+	  cancellation(0)
       {
       }
 
@@ -78,7 +88,8 @@ namespace scribo
       inline
       void Toolchain_Functor::on_progress()
       {
-	// Nothing
+	if (cancellation)
+	  cancellation->check();
       }
 
       inline
@@ -0,0 +1,107 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+/*
+ * Checks the row by row histograms of 8-bit 2D images against a site
+ * by site count, on images whose domain does not start at (0,0).
+ */
+
+#include <cstdio>
+
+#include <mln/core/image/image2d.hh>
+#include <mln/value/int_u8.hh>
+#include <mln/histo/compute.hh>
+
+#include <scribo/binarization/global_threshold_auto.hh>
+
+using namespace mln;
+
+namespace {
+image2d<value::int_u8> makeImage( const box2d& domain, unsigned seed )
+{
+    image2d<value::int_u8> ima( domain );
+    unsigned x = seed;
+    mln_piter_( box2d ) p( domain );
+    for_all( p ) {
+        x = x * 1103515245u + 12345u;
+        ima( p ) = ( x >> 16 ) % 256;
+    }
+    return ima;
+}
+
+int compare( const char* what, const histo::array<value::int_u8>& h,
+             const histo::array<value::int_u8>& ref )
+{
+    for ( unsigned i = 0; i < ref.nvalues(); ++i ) {
+        if ( h[i] != ref[i] ) {
+            std::printf( "FAIL %s: value %u counted %u times instead of %u\n",
+                         what, i, h[i], ref[i] );
+            return 1;
+        }
+    }
+    return 0;
+}
+}
+
+
+int main()
+{
+    int failures = 0;
+
+    const box2d domains[] = {
+        box2d( point2d( 0, 0 ), point2d( 40, 90 ) ),
+        box2d( point2d( 5, 7 ), point2d( 40, 90 ) ),
+        box2d( point2d( -12, -3 ), point2d( 30, 57 ) )
+    };
+
+    for ( unsigned d = 0; d < sizeof( domains ) / sizeof( domains[0] ); ++d ) {
+        const image2d<value::int_u8> ima = makeImage( domains[d], d + 1 );
+
+        histo::array<value::int_u8> ref;
+        image2d<unsigned> w( ima.domain() );
+        mln_piter_( box2d ) p( ima.domain() );
+        for_all( p ) {
+            ++ref[ima( p )];
+            w( p ) = ( p.row() + p.col() ) % 3;
+        }
+
+        failures += compare( "histo::compute", histo::compute( ima ), ref );
+        for ( unsigned nthreads = 1; nthreads <= 4; ++nthreads )
+            failures += compare( "histo::compute with threads",
+                                 histo::compute( ima, nthreads ), ref );
+
+        histo::array<value::int_u8> lines;
+        for_all( p )
+            if ( w( p ) == 0u )
+                ++lines[ima( p )];
+        failures += compare( "watershed line histogram",
+                             scribo::binarization::internal::watershed_line_histo( ima, w, 2 ),
+                             lines );
+    }
+
+    if ( failures == 0 )
+        std::printf( "PASS\n" );
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+/*
+ * Checks sauvola_ms_read() and sauvola_ms() on images down to 1x1:
+ * the gray level image read must be the source one, and reusing the
+ * first subscale must not change the binarization.
+ */
+
+#include <cstdio>
+
+#include <mln/core/image/image2d.hh>
+#include <mln/value/int_u8.hh>
+
+#include <scribo/binarization/sauvola_ms.hh>
+
+using namespace mln;
+
+namespace {
+/**
+ * Provides the rows of an image to sauvola_ms_read().
+ */
+class ImageRowReader
+{
+public:
+    ImageRowReader( const image2d<value::int_u8>& ima )
+        : m_ima( ima ),
+          m_row( 0 ) {
+    }
+
+    void read_row( value::int_u8* row ) {
+        for ( unsigned col = 0; col < m_ima.ncols(); ++col )
+            row[col] = m_ima.at_( m_row, col );
+        ++m_row;
+    }
+
+private:
+    const image2d<value::int_u8>& m_ima;
+    int m_row;
+};
+
+image2d<value::int_u8> makeImage( int nrows, int ncols, unsigned seed )
+{
+    image2d<value::int_u8> ima( nrows, ncols );
+    unsigned x = seed;
+    for ( int row = 0; row < nrows; ++row ) {
+        for ( int col = 0; col < ncols; ++col ) {
+            x = x * 1103515245u + 12345u;
+            ima.at_( row, col ) = ( ( row / 3 + col / 2 ) % 3 == 0 ? 40 : 200 ) + ( x >> 16 ) % 16;
+        }
+    }
+    return ima;
+}
+}
+
+
+int main()
+{
+    int failures = 0;
+
+    for ( unsigned s = 2; s <= 3; ++s ) {
+        for ( int nrows = 1; nrows <= 30; ++nrows ) {
+            for ( int ncols = 1; ncols <= 30; ++ncols ) {
+                const image2d<value::int_u8> ima = makeImage( nrows, ncols, nrows * 31 + ncols );
+
+                ImageRowReader reader( ima );
+                scribo::binarization::sauvola_ms_first_scale first;
+                const image2d<value::int_u8> read
+                    = scribo::binarization::sauvola_ms_read( reader, nrows, ncols, s, first );
+
+                const image2d<bool> ref = scribo::binarization::sauvola_ms( ima, 11, s );
+                const image2d<bool> bin
+                    = scribo::binarization::sauvola_ms( read, 11, s, SCRIBO_DEFAULT_SAUVOLA_K, 1, first );
+
+                bool same = read.domain() == ima.domain() && bin.domain() == ref.domain();
+                for ( int row = 0; same && row < nrows; ++row )
+                    for ( int col = 0; same && col < ncols; ++col )
+                        same = read.at_( row, col ) == ima.at_( row, col )
+                               && bin.at_( row, col ) == ref.at_( row, col );
+
+                if ( !same ) {
+                    std::printf( "FAIL %dx%d with s = %u\n", nrows, ncols, s );
+                    ++failures;
+                }
+            }
+        }
+    }
+
+    if ( failures == 0 )
+        std::printf( "PASS\n" );
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+// Copyright (C) 2011 EPITA Research and Development Laboratory (LRDE)
+//
+// This file is part of Olena.
+//
+// Olena is free software: you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free
+// Software Foundation, version 2 of the License.
+//
+// Olena is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Olena.  If not, see <http://www.gnu.org/licenses/>.
+//
+// As a special exception, you may use this file as part of a free
+// software project without restriction.  Specifically, if other files
+// instantiate templates or use macros or inline functions from this
+// file, or you compile this file and link it with other files to produce
+// an executable, this file does not by itself cause the resulting
+// executable to be covered by the GNU General Public License.  This
+// exception does not however invalidate any other reasons why the
+// executable file might be covered by the GNU General Public License.
+
+/*
+ * Checks the labeling by runs of an image with more components than
+ * the label type can count: the labels assigned before the labeling
+ * is aborted are kept, as with the video canvas, and there is one
+ * accumulator or attribute per label.
+ */
+
+#include <cstdio>
+
+#include <mln/core/image/image2d.hh>
+#include <mln/core/alias/neighb2d.hh>
+#include <mln/value/label_8.hh>
+#include <mln/accu/shape/bbox.hh>
+#include <mln/data/compare.hh>
+#include <mln/canvas/labeling/video.hh>
+#include <mln/labeling/value_and_compute.hh>
+
+using namespace mln;
+
+typedef value::label_8 L;
+
+int main()
+{
+    int failures = 0;
+
+    // 300 isolated sites, more than the 255 labels of label_8.
+    image2d<bool> ima( 30, 40 );
+    for ( int row = 0; row < 30; ++row )
+        for ( int col = 0; col < 40; ++col )
+            ima.at_( row, col ) = row % 2 == 0 && col % 2 == 0;
+
+    const neighb2d nbhs[] = { c4(), c8() };
+    for ( unsigned n = 0; n < 2; ++n ) {
+        bool val = true;
+        L refNlabels;
+        labeling::impl::value_functor<image2d<bool>, L> f( ima, val );
+        const image2d<L> ref = canvas::labeling::video( ima, nbhs[n], refNlabels, f );
+
+        for ( unsigned nthreads = 1; nthreads <= 4; ++nthreads ) {
+            L nlabels;
+            util::couple<image2d<L>,
+                         util::couple<util::array<box2d>,
+                                      util::array<accu::shape::bbox<point2d> > > >
+                r = labeling::value_and_compute( ima, true, nbhs[n], nlabels,
+                                                 accu::shape::bbox<point2d>(), nthreads );
+
+            bool same = nlabels == refNlabels && r.first() == ref
+                        && r.second().first().nelements() == unsigned( nlabels ) + 1;
+            for ( unsigned l = 1; same && l <= unsigned( nlabels ); ++l ) {
+                mln_piter_( box2d ) p( ref.domain() );
+                for_all( p )
+                    if ( ref( p ) == l )
+                        same = r.second().first()[l] == box2d( p, p );
+            }
+
+            if ( !same ) {
+                std::printf( "FAIL accumulators with c%u and %u threads\n",
+                             n ? 8 : 4, nthreads );
+                ++failures;
+            }
+
+            labeling::attributes2d attributes;
+            const image2d<L> output = labeling::value_and_compute( ima, true, nbhs[n], nlabels,
+                                                                   attributes, nthreads );
+
+            same = nlabels == refNlabels && output == ref
+                   && attributes.card.size() == unsigned( nlabels ) + 1;
+            for ( unsigned l = 1; same && l <= unsigned( nlabels ); ++l ) {
+                mln_piter_( box2d ) p( ref.domain() );
+                for_all( p )
+                    if ( ref( p ) == l )
+                        same = attributes.bbox( l ) == box2d( p, p ) && attributes.card[l] == 1;
+            }
+
+            if ( !same ) {
+                std::printf( "FAIL attributes with c%u and %u threads\n",
+                             n ? 8 : 4, nthreads );
+                ++failures;
+            }
+        }
+    }
+
+    if ( failures == 0 )
+        std::printf( "PASS\n" );
+    return failures == 0 ? 0 : 1;
+}
@@ -37,18 +37,23 @@
 # include <QtCore/QStringList>
 # include <QtCore/QTextStream>
 # include <QtCore/QTextCodec>
+# include <QtCore/QFuture>
+# include <QtCore/QtConcurrentRun>
 # include <QtGui/QImage>
 
+# include <cmath>
+# include <string>
+
 # include <mln/core/image/image2d.hh>
-# include <mln/data/transform.hh>
+# include <mln/core/routine/duplicate.hh>
 # include <mln/logical/not.hh>
 # include <mln/value/qt/rgb32.hh>
-# include <mln/fun/v2v/qt_rgb_to_int_u.hh>
 
 # include <scribo/convert/from_qimage.hh>
 # include <scribo/binarization/sauvola_ms.hh>
 # include <scribo/preprocessing/deskew.hh>
 # include <scribo/toolchain/text_in_doc.hh>
+# include <scribo/text/contains_text.hh>
 
 
 namespace scribo
@@ -60,6 +65,60 @@ namespace scribo
     namespace nepomuk
     {
 
+      /// Parameters of text_extraction().
+      struct text_extraction_params
+      {
+	text_extraction_params();
+
+	/// Language used by the OCR.
+	std::string ocr_language;
+
+	/// Window size of the multi-scale Sauvola binarization, at
+	/// the full resolution.
+	unsigned sauvola_window;
+
+	/// Subsampling ratio between the scales of the multi-scale
+	/// Sauvola binarization: 2 or 3.
+	unsigned sauvola_scale;
+
+	/// Number of threads used by the deskewing, the binarization
+	/// and the component extraction. The result does not depend
+	/// on it.
+	unsigned binarization_nthreads;
+
+	/// Number of threads recognizing the text lines, each with its
+	/// own OCR engine. The result does not depend on it.
+	unsigned ocr_nthreads;
+
+	/// Pictures skewed by at most this angle, in degrees, are not
+	/// rotated.
+	double deskew_min_angle;
+
+	/// Parameters of the text::contains_text() pre-check, run
+	/// before the expensive processing to skip pictures without
+	/// text. A size of 0 disables it. Increase the size or
+	/// decrease the number of components to trade speed for
+	/// recall.
+	unsigned precheck_size;
+	unsigned precheck_min_components;
+
+	/// Run the passes looking for text on the background and on
+	/// the foreground concurrently.
+	bool concurrent_passes;
+
+	/// If set, checked between the processing steps and between
+	/// text lines. Once it is canceled, text_extraction() returns
+	/// the text recognized so far.
+	const cancellation_token* cancellation;
+
+	/// If set, notified of each text line as soon as it is
+	/// recognized. Bounding boxes are expressed in the deskewed
+	/// image. With concurrent_passes, both passes notify it
+	/// concurrently.
+	text::recognition_observer* observer;
+      };
+
+
       /*! \brief Extract text from a document.
 
 	This is a convenient routine to be used in Nepomuk.
@@ -67,18 +126,95 @@ namespace scribo
 
 
 	\param[in] ima A document image. The
+	\param[in] params The extraction parameters.
 
 	\return A set of recognized words.
 
        */
       QString
-      text_extraction(const QImage& input);
+      text_extraction(const QImage& input,
+		      const text_extraction_params& params = text_extraction_params());
 
 
 # ifndef MLN_INCLUDE_ONLY
 
+      namespace internal
+      {
+
+	/// Text detection and recognition on a binary image.
+	///
+	/// Used to run one of the passes in a separate thread.
+	struct text_in_doc_pass
+	{
+	  void run();
+
+	  image2d<bool> input;
+	  std::string ocr_language;
+	  unsigned nthreads;
+	  unsigned ocr_nthreads;
+	  const cancellation_token* cancellation;
+	  text::recognition_observer* observer;
+
+	  line_set<image2d<scribo::def::lbl_type> > output;
+	};
+
+
+	inline
+	void
+	text_in_doc_pass::run()
+	{
+	  scribo::toolchain::internal::text_in_doc_functor<image2d<bool> > f;
+	  f.verbose = false;
+	  f.enable_denoising = false;
+	  f.ocr_language = ocr_language;
+	  f.components_nthreads = nthreads;
+	  f.ocr_nthreads = ocr_nthreads;
+	  f.cancellation = cancellation;
+	  f.ocr_observer = observer;
+
+	  try
+	  {
+	    output = f(input);
+	  }
+	  catch (const scribo::canceled&)
+	  {
+	    // Keep the lines recognized so far, if any.
+	    output = f.output;
+	  }
+	}
+
+
+	/// Return true if the extraction must stop.
+	inline
+	bool
+	is_canceled(const text_extraction_params& params)
+	{
+	  return params.cancellation != 0 && params.cancellation->is_canceled();
+	}
+
+      } // end of namespace scribo::toolchain::nepomuk::internal
+
+
+      inline
+      text_extraction_params::text_extraction_params()
+	: ocr_language("eng"),
+	  sauvola_window(101),
+	  sauvola_scale(3),
+	  binarization_nthreads(1),
+	  ocr_nthreads(1),
+	  deskew_min_angle(0.5),
+	  precheck_size(512),
+	  precheck_min_components(6),
+	  concurrent_passes(false),
+	  cancellation(0),
+	  observer(0)
+      {
+      }
+
+
       QString
-      text_extraction(const QImage& input)
+      text_extraction(const QImage& input,
+		      const text_extraction_params& params)
       {
 	trace::entering("scribo::toolchain::nepomuk::text_extraction");
 
@@ -86,25 +222,61 @@ namespace scribo
 
 	typedef image2d<scribo::def::lbl_type> L;
 
-	// Convert image to Milena's format.
-	mln::image2d<mln::value::qt::rgb32>
-	  input_mln = scribo::convert::from_qimage(input);
-
 	image2d<bool> input_bin;
 
 
 	// Preprocess
 	{
-	  // Convert to Gray level image.
+	  // Convert to a gray level image in Milena's format and
+	  // compute the first subscale of sauvola_ms in the same pass.
+	  scribo::convert::qimage_int_u8_row_reader reader(input);
+	  scribo::binarization::sauvola_ms_first_scale first_scale;
 	  image2d<value::int_u8>
-	    input_gl = data::transform(input_mln,
-				       mln::fun::v2v::qt_rgb_to_int_u<8>());
+	    input_gl = scribo::binarization::sauvola_ms_read(reader,
+							     reader.nrows(),
+							     reader.ncols(),
+							     params.sauvola_scale,
+							     first_scale);
+
+	  if (internal::is_canceled(params))
+	  {
+	    trace::exiting("scribo::toolchain::nepomuk::text_extraction");
+	    return QString();
+	  }
+
+	  // Skip pictures without text.
+	  if (params.precheck_size != 0
+	      && !text::contains_text(input_gl, params.precheck_size,
+				      params.precheck_min_components))
+	  {
+	    trace::exiting("scribo::toolchain::nepomuk::text_extraction");
+	    return QString();
+	  }
 
 	  // Deskew if needed.
-	  input_gl = preprocessing::deskew(input_gl);
+	  double angle, confidence;
+	  input_gl = preprocessing::deskew(input_gl, params.deskew_min_angle,
+					   params.binarization_nthreads,
+					   angle, confidence);
+	  const bool rotated = std::fabs(angle) > params.deskew_min_angle;
+
+	  // The first subscale is computed again from the rotated image.
+	  if (rotated)
+	    first_scale = scribo::binarization::sauvola_ms_first_scale();
+
+	  if (internal::is_canceled(params))
+	  {
+	    trace::exiting("scribo::toolchain::nepomuk::text_extraction");
+	    return QString();
+	  }
 
 	  // Binarize foreground to use it in the processing chain.
-	  input_bin = scribo::binarization::sauvola_ms(input_gl, 101, 3);
+	  input_bin = scribo::binarization::sauvola_ms(input_gl,
+							 params.sauvola_window,
+							 params.sauvola_scale,
+							 SCRIBO_DEFAULT_SAUVOLA_K,
+							 params.binarization_nthreads,
+							 first_scale);
 	}
 
 
@@ -113,28 +285,72 @@ namespace scribo
 	line_set<L> lines_bg, lines_fg;
 	// Process
 	{
-	  // Run document toolchain.
-	  lines_bg = scribo::toolchain::text_in_doc(input_bin, false, false);
-
-	  // Negate document.
-	  logical::not_inplace(input_bin);
-
-	  // Run document toolchain.
-	  lines_fg = scribo::toolchain::text_in_doc(input_bin, false, false);
+	  // Both passes use the same OCR language so that the second
+	  // one reuses the engine pooled by the first one.
+	  internal::text_in_doc_pass bg, fg;
+	  bg.ocr_language = params.ocr_language;
+	  fg.ocr_language = params.ocr_language;
+	  bg.nthreads = params.binarization_nthreads;
+	  fg.nthreads = params.binarization_nthreads;
+	  bg.ocr_nthreads = params.ocr_nthreads;
+	  fg.ocr_nthreads = params.ocr_nthreads;
+	  bg.cancellation = params.cancellation;
+	  fg.cancellation = params.cancellation;
+	  bg.observer = params.observer;
+	  fg.observer = params.observer;
+
+	  if (params.concurrent_passes)
+	  {
+	    // Milena images share their data and the sharing is not
+	    // thread-safe: each pass gets its own image and this
+	    // thread does not keep any reference to the background
+	    // one.
+	    fg.input = duplicate(input_bin);
+	    logical::not_inplace(fg.input);
+
+	    bg.input = input_bin;
+	    input_bin.destroy();
+
+	    // Run document toolchain on both images.
+	    QFuture<void> bg_done = QtConcurrent::run(&bg,
+						      &internal::text_in_doc_pass::run);
+	    fg.run();
+	    bg_done.waitForFinished();
+	  }
+	  else
+	  {
+	    // Run document toolchain.
+	    bg.input = input_bin;
+	    bg.run();
+
+	    // Negate document.
+	    logical::not_inplace(input_bin);
+
+	    // Run document toolchain.
+	    fg.input = input_bin;
+	    fg.run();
+	  }
+
+	  lines_bg = bg.output;
+	  lines_fg = fg.output;
 	}
 
 
 	QString output;
 
 	// Construct output
+	//
+	// A pass canceled before recognizing text has no lines.
 	{
-	  for_all_lines(l, lines_bg)
-	    if (lines_bg(l).has_text())
-	      output += QLatin1String(" ") + QString::fromUtf8(lines_bg(l).text().c_str());
-
-	  for_all_lines(l, lines_fg)
-	    if (lines_fg(l).has_text())
-              output += QLatin1String(" ") + QString::fromUtf8(lines_fg(l).text().c_str());
+	  if (lines_bg.is_valid())
+	    for_all_lines(l, lines_bg)
+	      if (lines_bg(l).has_text())
+		output += QLatin1String(" ") + QString::fromUtf8(lines_bg(l).text().c_str());
+
+	  if (lines_fg.is_valid())
+	    for_all_lines(l, lines_fg)
+	      if (lines_fg(l).has_text())
+		output += QLatin1String(" ") + QString::fromUtf8(lines_fg(l).text().c_str());
 
 	}
 